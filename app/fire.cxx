@@ -6,6 +6,7 @@
 #include <iostream>
 #include "fire/config/Python.h"
 #include "fire/Process.h"
+#include "fire/Workers.h"
 
 /**
  * Print how to use this executable to the terminal.
@@ -14,7 +15,11 @@ static void usage() {
   std::cout << 
     "\n"
     " USAGE:\n"
-    "  fire {configuration_script.py} [arguments to configuration script]\n"
+    "  fire [--workers N] {configuration_script.py} [arguments to configuration script]\n"
+    "\n"
+    " OPTIONS:\n"
+    "  --workers N              (optional) "
+    "fork N worker processes splitting the input files\n"
     "\n"
     " ARGUMENTS:\n"
     "  configuration_script.py  (required) "
@@ -34,6 +39,10 @@ static void usage() {
  *    the corresponding C++ classes by creating the Process.
  * 2. Running - we run the Process that has been configured.
  *
+ * With the '--workers N' option, the configured Process is
+ * not created here. Instead, N worker processes each create
+ * their own and split the input files (see fire::runWorkers).
+ *
  * @param[in] argc command line argument count
  * @param[in] argv array of command line arguments
  */
@@ -56,14 +65,25 @@ int main(int argc, char* argv[]) {
     return 1;
   }
 
+  int num_workers = 0;
+  for (int i = 1; i < ptrpy; i++) {
+    if (strcmp(argv[i], "--workers") == 0 and i + 1 < ptrpy) {
+      num_workers = atoi(argv[++i]);
+    } else {
+      usage();
+      std::cout << " ** Unrecognized option '" << argv[i] << "'. ** " << std::endl;
+      return 1;
+    }
+  }
+
   std::cout << "---- FIRE: Loading configuration --------" << std::endl;
 
   std::unique_ptr<fire::Process> p;
+  fire::config::Parameters config;
   try {
-    fire::config::Parameters config{
-        fire::config::run("fire.cfg.Process.lastProcess", 
-            argv[ptrpy], argv + ptrpy + 1, argc - ptrpy - 1)};
-    p = std::make_unique<fire::Process>(config);
+    config = fire::config::run("fire.cfg.Process.lastProcess", 
+            argv[ptrpy], argv + ptrpy + 1, argc - ptrpy - 1);
+    if (num_workers < 1) p = std::make_unique<fire::Process>(config);
   } catch (const fire::Exception& e) {
     std::cerr << "[" << e.category() << "] " << e.message() << std::endl;
     if (not e.trace().empty()) {
@@ -75,6 +95,25 @@ int main(int argc, char* argv[]) {
     return 127;
   }
 
+  if (num_workers > 0) {
+    std::cout << "---- FIRE: Starting event processing with " << num_workers
+              << " workers --------" << std::endl;
+    try {
+      fire::runWorkers(config, num_workers);
+    } catch (const fire::Exception& e) {
+      std::cerr << "[" << e.category() << "] " << e.message() << std::endl;
+      if (not e.trace().empty()) {
+        std::cerr << "Stack Trace:\n" << e.trace() << std::endl;
+      }
+      return 2;
+    } catch (const std::exception& e) {
+      std::cerr << "UNKNOWN EXCEPTION: " << e.what() << std::endl;
+      return 127;
+    }
+    std::cout << "---- FIRE: Event processing complete  --------" << std::endl;
+    return 0;
+  }
+
   std::cout << "---- FIRE: Starting event processing --------" << std::endl;
 
   // successfully creating the Process also means the logger
@@ -9,6 +9,7 @@
 #include "fire/logging/Logger.h"
 
 #include <map>
+#include <mutex>
 
 namespace fire {
 
@@ -88,6 +89,14 @@ class Conditions {
    * the ConditionsProvider::getCondition method
    * will be called to provide the object.
    *
+   * Processors handling separate events at once may request conditions
+   * at the same time, so the cache is guarded by a mutex. The event is
+   * the one being processed on the calling thread (Process::eventHeader).
+   *
+   * @note A cached object is released as soon as an event outside of its
+   * IOV asks for the condition, so providers whose conditions change within
+   * a run should not be used with more than one thread.
+   *
    * @throws Exception if condition object or provider for that object is not
    * found.
    *
@@ -172,6 +181,9 @@ class Conditions {
 
   /** Conditions cache */
   std::map<std::string, CacheEntry> cache_;
+
+  /// guard the cache from requests on several threads
+  mutable std::mutex cache_mutex_;
 };
 
 }  // namespace fire
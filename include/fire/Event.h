@@ -1,12 +1,18 @@
 #ifndef FIRE_EVENT_H
 #define FIRE_EVENT_H
 
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
 #include <regex>
+#include <unordered_set>
 #include <boost/core/demangle.hpp>
 
 #include "fire/io/Data.h"
 #include "fire/io/ClassVersion.h"
 #include "fire/EventHeader.h"
+#include "fire/EventHandle.h"
 
 namespace fire {
 
@@ -24,6 +30,43 @@ class UserReader;
  * the orginizational work behind the scenes using private methods
  * while the public methods are the only ones available to processors
  * written by users.
+ *
+ * ## Lazy Loading
+ * By default, every object read from the input file is loaded on each
+ * entry. In lazy mode, the objects besides the EventHeader only count
+ * how many entries they are behind on each Event::load. They are brought
+ * up to the current entry when Event::get asks for them (or when they
+ * are saved), skipping the entries in between through the input file
+ * (io::Reader::skip_into) without loading them.
+ *
+ * ## Several Events at Once
+ * When the Process handles several events at once, each has its own
+ * Event but they all read from the same input file and write to the same
+ * output file. The events share a record of the objects any of them have
+ * created so that each can create its own copy (see Event::shareWith), and
+ * they lock the input file while reading from it. Everything touching the
+ * output file happens in Event::save, which the Process only calls from
+ * one thread at a time.
+ *
+ * ## Several Processors at Once
+ * When the Process runs independent processors on the same event at once,
+ * Event::add, Event::get, and Event::search lock the event so that the
+ * in-memory objects are only created and looked up by one of them at a
+ * time (see Event::processConcurrently).
+ *
+ * ## Handles
+ * Processors that get or add the same objects on every event can
+ * use an EventHandle instead of the object name. The event remembers
+ * the in-memory object each handle refers to, so only the first use of
+ * a handle does the name lookups and type check (see Event::get).
+ *
+ * ## Catalog
+ * The available objects are indexed by name and by full name (pass/name)
+ * so that looking up an object by its exact name does not go through
+ * the regular expressions of Event::search. The patterns given to
+ * Event::search are compiled once and its results are remembered,
+ * only matching the objects that became available since the last
+ * time the same search was done.
  */
 class Event {
  public:
@@ -179,6 +222,11 @@ class Event {
    * An empty matching string is interpreted as the "match anything"
    * regex '.*'.
    *
+   * The results are remembered until a new input file is attached, so
+   * repeating a search only matches the objects that became available
+   * since it was last done. At most MAX_CACHED_SEARCHES different
+   * searches are remembered, after that all of them are forgotten.
+   *
    * @param[in] namematch regex to match name of event object
    * @param[in] passmatch regex to match pass of event object
    * @param[in] typematch regex to match demangled type of event object
@@ -195,13 +243,22 @@ class Event {
    * that a following 'get' call will only fail if the wrong type is provided.
    * In order to check for any existence, use Event::search.
    *
+   * The name and pass are regular expressions like in Event::search,
+   * but the name must match all of the object name. If neither of them
+   * has any special characters, they are looked up in the catalog of
+   * available objects directly instead of searching.
+   *
    * @param[in] name Name of event object
    * @param[in] pass (optional) name of pass that created the event object
    * @return true if there is exactly one available object matching the name
    * and pass
    */
   bool exists(const std::string& name, const std::string& pass = "") const {
-    return search("^" + name + "$", pass, "").size() == 1;
+    if (isPattern(name) or isPattern(pass)) return search("^" + name + "$", pass, "").size() == 1;
+    auto access_lock{lockAccess()};
+    if (not pass.empty()) return available(fullName(name, pass)) != nullptr;
+    auto named{names_.find(name)};
+    return named != names_.end() and named->second.size() == 1;
   }
 
   /**
@@ -224,10 +281,10 @@ class Event {
    *  should_load : false, this is a new object and is not being read in
    *  updated : false, we haven't updated it yet
    *
-   * Finally, if we end up needing to save this object, we also making
-   * sure to call h5::Data::save enough times to align the number of 
-   * entries in the serialized data with the current number of entries
-   * we are on (Event::i_entry_).
+   * Finally, the new object is recorded for the other events in flight.
+   * If we end up needing to save this object, the first Event::save
+   * also saves the default value for all of the entries already in the
+   * output file so that the entries stay aligned with the other objects.
    *
    * @throw Exception if two data sets of the same name and the same pass 
    * are added
@@ -241,8 +298,10 @@ class Event {
   template <typename DataType>
   void add(const std::string& name, const DataType& data) {
     static const bool ADD_KEEP_DEFAULT = true;
+    auto access_lock{lockAccess()};
     std::string full_name{fullName(name, pass_)};
-    if (objects_.find(full_name) == objects_.end()) {
+    std::size_t id{objectId(full_name)};
+    if (id == NO_OBJECT) {
       // check available_objects_ listing so we don't in-advertently replace 
       //   any datasets of the same name read in from the inputfile
       // we know we are worried about data from the input file
@@ -251,14 +310,14 @@ class Event {
       // we rely on trusting that setInputFile gets the listing
       //   of event objects from the input file and puts them
       //   into availble_objects_
-      if (search("^"+name+"$","^"+pass_+"$",".*").size() > 0) {
+      if (available(full_name)) {
         throw Exception("Repeat",
             "Data named "+full_name+" already exists in the input file.");
       }
-      auto& tag{available_objects_.emplace_back(name, pass_,
+      auto& tag{makeAvailable({name, pass_,
                   boost::core::demangle(typeid(DataType).name()),
                   io::class_version<DataType>,
-                  keep(full_name, ADD_KEEP_DEFAULT))};
+                  keep(full_name, ADD_KEEP_DEFAULT)})};
       tag.loaded_ = true;
 
       // a data set hasn't been created for this data yet
@@ -271,25 +330,21 @@ class Event {
       //   we do save these datasets
       // - we mark these objects as should_load == false because
       //   they are new and not from an input file
-      auto& obj{objects_[full_name]};
+      id = newObject(full_name);
+      auto& obj{objects_[id]};
       obj.data_ = std::make_unique<io::Data<DataType>>(io::constants::EVENT_GROUP+"/"+full_name);
       obj.should_save_ = tag.keep_;
       obj.should_load_ = false;
       obj.updated_ = false;
 
-      // if we are saving this object, we should save the structure and the default value 
-      // for all entries up to this one. This (along with 'clearing' at the end of each event) 
-      // allows users to asyncronously add event objects and the events without an 'add'
-      // have a 'default' or 'cleared' object value.
-      if (obj.should_save_) {
-        obj.data_->structure(*output_file_);
-        obj.data_->clear();
-        for (std::size_t i{0}; i < i_entry_; i++)
-          obj.data_->save(*output_file_);
-      }
+      // if we are saving this object, Event::save will save the structure and the
+      // default value for the entries already written. This (along with 'clearing' at
+      // the end of each event) allows users to asyncronously add event objects and the
+      // events without an 'add' have a 'default' or 'cleared' object value.
+      share<DataType>(full_name, tag, false);
     }
 
-    auto& obj{objects_.at(full_name)};
+    auto& obj{objects_[id]};
     if (obj.updated_) {
       // this data set has been updated by another processor in the sequence
       throw Exception("Repeat",
@@ -315,8 +370,8 @@ class Event {
    * deduction of what the pass name should be. If the pass name is
    * provided, all of the deduction procedure is skippped. A cache
    * of known name -> name+pass deductions is kept in Event::known_lookups_
-   * to save time. The deduction is pretty simple, we use
-   * Event::search with the input name and the demangled input type
+   * to save time. The deduction is pretty simple, we look up
+   * the input name in the catalog of available objects
    * in order to retrieve a list of options. If the list of options
    * is empty or has more than one element, we throw an exception, 
    * otherwise, we have successfully deduced the pass name.
@@ -330,9 +385,10 @@ class Event {
    *  should_save: use Event::keep with the default of `false`
    *  should_load: true since this is a reading 
    *  updated: false
-   * We also use h5::Data::load to get the reading pointer to the entry
+   * We also use io::Reader::seek_into to get the reading pointer to the entry
    * in the data set corresponding to the current entry we are on
-   * (Event::i_entry_).
+   * (Event::i_entry_) and then load it. The new object is recorded
+   * for the other events in flight (Event::share).
    *
    * After all of this setup, we attempt to retrieve the a constant
    * reference to the data stored in the in-memory object.
@@ -348,6 +404,7 @@ class Event {
   template <typename DataType>
   const DataType& get(const std::string& name,
                       const std::string& pass = "") const {
+    auto access_lock{lockAccess()};
     std::string full_name, type;
     if (not pass.empty()) {
       // easy case, pass was specified explicitly
@@ -355,24 +412,26 @@ class Event {
     } else if (known_lookups_.find(name) != known_lookups_.end()) {
       full_name = known_lookups_.at(name);
     } else {
-      // need to search current (and potential) available_objects using partial name
-      auto options{search("^" + name + "$", ".*", ".*")};
-      if (options.size() == 0) {
+      // need to look through current (and potential) available_objects using partial name
+      auto named{names_.find(name)};
+      if (named == names_.end() or named->second.empty()) {
         throw Exception("Miss",
             "Data " + name + " not found.");
-      } else if (options.size() > 1) {
+      } else if (named->second.size() > 1) {
         throw Exception("Ambig",
             "Data " + name + " is ambiguous. Provide a pass name.");
       }
 
       // exactly one option
-      full_name = fullName(options.at(0).name(), options.at(0).pass());
-      type = options.at(0).type();
+      const auto& option{available_objects_.at(named->second.front())};
+      full_name = fullName(option.name(), option.pass());
+      type = option.type();
       // add into cache
       known_lookups_[name] = full_name;
     }
 
-    if (objects_.find(full_name) == objects_.end()) {
+    std::size_t id{objectId(full_name)};
+    if (id == NO_OBJECT) {
       // final check for input file, never should enter here without one
       if (not input_file_) {
         throw Exception("Miss",
@@ -383,11 +442,11 @@ class Event {
       // when setting up the in-memory object, we need to find the tag so we can
       // 1. get whether the object should be copied to the output file and
       // 2. set the loaded_ flag to true
-      // we can do a simple linear search since this will only happen once per input file
-      auto tag_it = std::find_if(available_objects_.begin(), available_objects_.end(), 
-          [&full_name,this](const EventObjectTag& tag) {
-            return fullName(tag.name(),tag.pass()) == full_name;
-          });
+      const EventObjectTag* tag_it{available(full_name)};
+      if (not tag_it) {
+        throw Exception("Miss",
+            "Data " + full_name + " not found.");
+      }
       tag_it->loaded_ = true;
 
       // a data set hasn't been created for this data yet
@@ -400,7 +459,9 @@ class Event {
       //   we do save these datasets
       // - we mark these objects as should_load == false because
       //   they are new and not from an input file
-      auto& obj{objects_[full_name]};
+      id = newObject(full_name);
+      auto& obj{objects_[id]};
+      auto input_lock{lockInput()};
       obj.data_ = std::make_unique<io::Data<DataType>>(io::constants::EVENT_GROUP+"/"+full_name, 
           input_file_);
       obj.should_save_ = tag_it->keep();
@@ -410,19 +471,10 @@ class Event {
       // get this object up to the current entry
       //    loading may throw an H5 error if the shape of the data on disk
       //    cannot be loaded into the input type
+      //  if this object should be saved, Event::save copies the structure
+      //  into the output file
       try {
-        // copy structure into output file if this object should be saved
-        if (obj.should_save_) {
-          obj.data_->structure(*output_file_);
-        }
-        
-        if (not obj.should_save_ or not input_file_->canCopy()) {
-          // only skip the first i_entry_ entries if the input file cannot copy
-          // or the object is not being saved
-          //  the objects that are being saved are being mirrored by the input file
-          //  if the input file can copy
-          for (std::size_t i{0}; i < i_entry_; i++) input_file_->load_into(*obj.data_);
-        }
+        input_file_->seek_into(*obj.data_, i_entry_);
         input_file_->load_into(*obj.data_);
       } catch (const HighFive::DataSetException&) {
         throw Exception("BadType",
@@ -430,11 +482,16 @@ class Event {
             + boost::core::demangle(typeid(DataType).name())
             + " from the type it was written as " + type);
       }
+      if (input_lock) input_lock.unlock();
+      share<DataType>(full_name, *tag_it, true);
     }
 
+    // lazily loaded objects may not be on the current entry yet
+    catchUp(objects_[id]);
+
     // type casting, 'bad_cast' thrown if unable
     try {
-      return objects_[full_name].getDataRef<DataType>().get();
+      return objects_[id].getDataRef<DataType>().get();
     } catch (const std::bad_cast&) {
       throw Exception("BadType",
           "Data " + full_name + " was initialy loaded with type " + type
@@ -443,6 +500,80 @@ class Event {
     }
   }
 
+  /**
+   * add a piece of data to the event through a handle
+   *
+   * The first time the handle is used, this is the same as adding
+   * the data by the handle's name. Afterwards, the data is given
+   * directly to the in-memory object the handle refers to.
+   *
+   * @throw Exception if the object was already added on this event
+   * @throw Exception (on first use) for the same reasons as adding by name
+   *
+   * @tparam DataType type of data being added
+   * @param[in] handle handle to the object being added
+   * @param[in] data actual value of data being added
+   */
+  template <typename DataType>
+  void add(const EventHandle<DataType>& handle, const DataType& data) {
+    auto access_lock{lockAccess()};
+    auto& slot{handleSlot(handle.id())};
+    if (slot.added == NO_OBJECT) {
+      add<DataType>(handle.name(), data);
+      slot.added = objectId(fullName(handle.name(), pass_));
+      return;
+    }
+
+    auto& obj{objects_[slot.added]};
+    if (obj.updated_) {
+      throw Exception("Repeat",
+          "Data named " + fullName(handle.name(), pass_) + " already added to the event"
+          " by a previous producer in the sequence.");
+    }
+    // the type was checked when the handle was first used
+    static_cast<io::Data<DataType>&>(*obj.data_).update(data);
+    obj.updated_ = true;
+  }
+
+  /**
+   * get a piece of data from the event through a handle
+   *
+   * The first time the handle is used, this is the same as getting
+   * the data by the handle's name (and pass). Afterwards, we only
+   * make sure the in-memory object is on the current entry before
+   * returning it.
+   *
+   * @throw Exception (on first use) for the same reasons as getting by name
+   *
+   * @tparam DataType type of requested data
+   * @param[in] handle handle to the requested object
+   * @return const reference to data in event
+   */
+  template <typename DataType>
+  const DataType& get(const EventHandle<DataType>& handle) const {
+    return *getThrough(handle, true);
+  }
+
+  /**
+   * get a piece of data from the event if it is there
+   *
+   * This is for optional objects. Instead of throwing an exception,
+   * we return a null pointer if there is no object with the handle's
+   * name (and pass) or if the object is created by processors and was
+   * not added on this event. While the object is missing, the available
+   * objects are only searched again once new objects are available.
+   *
+   * @throw Exception if the object is ambiguous or has a different type
+   *
+   * @tparam DataType type of requested data
+   * @param[in] handle handle to the requested object
+   * @return pointer to data in event, nullptr if it is not there
+   */
+  template <typename DataType>
+  const DataType* tryGet(const EventHandle<DataType>& handle) const {
+    return getThrough(handle, false);
+  }
+
   /// Delete the copy constructor to prevent any in-advertent copies.
   Event(const Event&) = delete;
 
@@ -472,12 +603,78 @@ class Event {
    * This behavior is helpful for our use case because we can have general
    * rules and then various exceptions.
    *
+   * A rule is only matched against the name if the name starts with the
+   * literal prefix of its regex, and the decision of the rules for each
+   * name is remembered for the following input files and new objects.
+   *
    * @param[in] full_name object name including the pass prefix
    * @param[in] def default drop/keep decision value
    * @return true if object should be saved into the output file
    */
   bool keep(const std::string& full_name, bool def) const;
 
+  /**
+   * Add a tag to the available objects and index it in the catalog
+   *
+   * @param[in] tag tag of newly available object
+   * @return reference to the tag in the available objects
+   */
+  EventObjectTag& makeAvailable(EventObjectTag tag);
+
+  /**
+   * Look up an available object by its full name
+   *
+   * @param[in] full_name object name including the pass prefix
+   * @return pointer to the tag of the object, nullptr if it is not available
+   */
+  const EventObjectTag* available(const std::string& full_name) const {
+    auto indexed{full_names_.find(full_name)};
+    return indexed == full_names_.end() ? nullptr : &available_objects_[indexed->second];
+  }
+
+  /**
+   * Lock the input file if it is shared with other events in flight
+   *
+   * @return lock on the input mutex, or an empty lock if we are alone
+   */
+  std::unique_lock<std::mutex> lockInput() const {
+    return input_mutex_ ? std::unique_lock<std::mutex>{*input_mutex_}
+                        : std::unique_lock<std::mutex>{};
+  }
+
+  /**
+   * Lock the event if several processors may be using it at once
+   *
+   * @return lock on the access mutex, or an empty lock if processors run in order
+   */
+  std::unique_lock<std::recursive_mutex> lockAccess() const {
+    return concurrent_ ? std::unique_lock<std::recursive_mutex>{access_mutex_}
+                       : std::unique_lock<std::recursive_mutex>{};
+  }
+
+  /**
+   * Record a newly created object for the other events in flight
+   *
+   * Only the first event to create an object records it.
+   *
+   * @tparam DataType type of the object
+   * @param[in] full_name object name including the pass prefix
+   * @param[in] tag available object tag for the new object
+   * @param[in] should_load true if the object is read from the input file
+   */
+  template <typename DataType>
+  void share(const std::string& full_name, const EventObjectTag& tag,
+             bool should_load) const {
+    std::lock_guard<std::mutex> lock{shared_->mutex};
+    if (shared_->index.find(full_name) != shared_->index.end()) return;
+    shared_->index[full_name] = shared_->objects.size();
+    shared_->objects.push_back({tag, should_load, 
+        [path = io::constants::EVENT_GROUP+"/"+full_name](io::Reader* r) 
+          -> std::unique_ptr<io::BaseData> {
+          return std::make_unique<io::Data<DataType>>(path, r);
+        }});
+  }
+
  private:
   /**
    * The Process is the Event's friend,
@@ -509,20 +706,69 @@ class Event {
    *
    * @param[in] pass name of current processing pass
    * @param[in] dk_rules configuration for the drop/keep rules
+   * @param[in] lazy only load input objects when they are asked for
    */
   Event(io::Writer* output_file,
         const std::string& pass,
-        const std::vector<config::Parameters>& dk_rules);
+        const std::vector<config::Parameters>& dk_rules,
+        bool lazy = false);
+
+  /**
+   * Process this event at the same time as the other one
+   *
+   * We start using the other event's record of created objects
+   * and lock the input mutex whenever we read from the input file.
+   * Since the other events may have moved the shared input data
+   * anywhere, we also seek to our entry before every load.
+   *
+   * @note This must be called before any objects are created.
+   *
+   * @param[in] other event to share the record of objects with
+   * @param[in] input_mutex mutex guarding the input file
+   */
+  void shareWith(const Event& other, std::mutex& input_mutex);
+
+  /**
+   * Allow several processors to use this event at once
+   *
+   * After this, Event::add, Event::get, and Event::search
+   * lock the event while they look up or create objects.
+   */
+  void processConcurrently() { concurrent_ = true; }
+
+  /**
+   * Create the objects that other events in flight have created
+   *
+   * The new objects are loaded from the input file when they are
+   * needed, so this can be called before Event::seek or Event::save.
+   */
+  void sync();
 
   /**
    * Go through and save the current in-memory objects into
    * the output file.
+   *
+   * The first time each object is saved, we copy its structure into
+   * the output file. The previous entries of objects read from the
+   * input file are copied by the input file, so we finish those copies
+   * first. Objects created during processing did not exist on the
+   * entries already in the output file, so we save their default
+   * value for each of those entries.
+   *
+   * The same goes for objects copied from the input file that first
+   * appear after entries have been written without them, and copied
+   * objects missing from the input file are saved as cleared entries.
+   * This keeps the entries aligned when the input files do not all
+   * have the same objects (e.g. merging the outputs of several workers).
    */
   void save();
 
   /**
    * Go through and load the next entry into the in-memory
    * objects from the input file.
+   *
+   * In lazy mode, only the event header is loaded and the
+   * other objects record that they are one more entry behind.
    */
   void load();
 
@@ -536,6 +782,22 @@ class Event {
    */
   void setInputFile(io::Reader* r);
 
+  /**
+   * Move to an entry in the input file
+   *
+   * We set our entry index and reset the event objects to their
+   * empty state like Event::next. Then the objects loaded from the
+   * input file are moved to the entry (io::Reader::seek_into)
+   * so that the next Event::load reads that entry.
+   *
+   * @note The input file must have just been attached
+   * (with setInputFile) if it is unable to seek, since
+   * those readers skip entries by loading them.
+   *
+   * @param[in] i_entry index of entry for next load to read
+   */
+  void seek(std::size_t i_entry);
+
   /**
    * Move to the next event
    *  we just need to keep our entry index up-to-date
@@ -566,6 +828,8 @@ class Event {
    * structure to hold event data in memory
    */
   struct EventObject {
+    /// name including the pass prefix
+    std::string full_name_;
     /**
      * the data for save/load
      */
@@ -576,6 +840,10 @@ class Event {
     bool should_load_;
     /// have we been updated on the current event?
     bool updated_;
+    /// number of entries we have not loaded yet (lazy mode only)
+    std::size_t behind_{0};
+    /// has the output file been set up to save us?
+    bool in_output_{false};
     /**
      * Helper for getting a reference to the dataset
      *
@@ -596,17 +864,235 @@ class Event {
       data_->clear();
     }
   };
-  /// list of event objects being processed
-  mutable std::unordered_map<std::string, EventObject> objects_;
+
+  /// id of no in-memory object
+  static constexpr std::size_t NO_OBJECT{std::numeric_limits<std::size_t>::max()};
+
+  /// id of the event header, it is the first in-memory object
+  static constexpr std::size_t HEADER_ID{0};
+
+  /// number of different searches to remember, see Event::search
+  static constexpr std::size_t MAX_CACHED_SEARCHES{256};
+
+  /**
+   * Is the input string a regular expression matching more than itself?
+   * @param[in] s string to check
+   * @return true if the string has any of the special characters of a regex
+   */
+  static bool isPattern(const std::string& s) {
+    return s.find_first_of(".[]()*+?{}|^$\\") != std::string::npos;
+  }
+
+  /**
+   * Get the id of an in-memory object
+   *
+   * @param[in] full_name object name including the pass prefix
+   * @return id of the object, NO_OBJECT if it is not in memory
+   */
+  std::size_t objectId(const std::string& full_name) const {
+    auto indexed{object_ids_.find(full_name)};
+    return indexed == object_ids_.end() ? NO_OBJECT : indexed->second;
+  }
+
+  /**
+   * Create a new in-memory object
+   *
+   * The ids stay the same as objects are created, so they can be
+   * remembered while references to the objects cannot.
+   *
+   * @param[in] full_name object name including the pass prefix
+   * @return id of the new object
+   */
+  std::size_t newObject(const std::string& full_name) const {
+    std::size_t id{objects_.size()};
+    objects_.emplace_back().full_name_ = full_name;
+    object_ids_[full_name] = id;
+    return id;
+  }
+
+  /**
+   * Bring an object that is behind up to the current entry
+   *
+   * The entries before the current one are skipped through the
+   * input file and then the current entry is loaded.
+   *
+   * @param[in] obj event object to catch up
+   */
+  void catchUp(EventObject& obj) const;
+
+  /**
+   * Set up the output file to save the input object
+   *
+   * This is only done once for each object name among
+   * all of the events sharing the record of objects.
+   *
+   * @param[in] full_name object name including the pass prefix
+   * @param[in] obj event object that is about to be saved
+   */
+  void setUpOutput(const std::string& full_name, EventObject& obj);
+
+  /**
+   * In-memory objects found through a handle
+   */
+  struct HandleSlot {
+    /// id of the object the handle gets, NO_OBJECT if not found yet
+    std::size_t got{NO_OBJECT};
+    /// id of the object the handle adds, NO_OBJECT if not added yet
+    std::size_t added{NO_OBJECT};
+    /// number of available objects when the handle last missed
+    std::size_t checked{0};
+  };
+
+  /**
+   * Get the objects found through a handle
+   *
+   * @param[in] id id of handle
+   * @return slot for the handle's objects
+   */
+  HandleSlot& handleSlot(std::size_t id) const {
+    if (id >= handles_.size()) handles_.resize(id + 1);
+    return handles_[id];
+  }
+
+  /**
+   * Get a piece of data through a handle
+   *
+   * The object is found by name the first time and remembered in the
+   * handle's slot. If the object is not required, we check that it is
+   * there before getting it by name so that no exception is thrown.
+   *
+   * @tparam DataType type of requested data
+   * @param[in] handle handle to the requested object
+   * @param[in] required throw if the object is missing instead of returning nullptr
+   * @return pointer to data in event, nullptr if not required and missing
+   */
+  template <typename DataType>
+  const DataType* getThrough(const EventHandle<DataType>& handle, bool required) const {
+    auto access_lock{lockAccess()};
+    auto& slot{handleSlot(handle.id())};
+    if (slot.got == NO_OBJECT) {
+      if (not required) {
+        if (slot.checked == available_objects_.size()) return nullptr;
+        slot.checked = available_objects_.size();
+        if (handle.pass().empty() ? names_.find(handle.name()) == names_.end()
+                                  : not available(fullName(handle.name(), handle.pass())))
+          return nullptr;
+      }
+      get<DataType>(handle.name(), handle.pass());
+      slot.got = objectId(handle.pass().empty() ? known_lookups_.at(handle.name())
+                                                : fullName(handle.name(), handle.pass()));
+    }
+
+    // objects created by processors are only there on the events they are added
+    auto& obj{objects_[slot.got]};
+    if (not required and not obj.should_load_ and not obj.updated_) return nullptr;
+
+    // lazily loaded objects may not be on the current entry yet
+    catchUp(obj);
+    // the type was checked when the handle first got the object
+    return &static_cast<io::Data<DataType>&>(*obj.data_).get();
+  }
+
+  /**
+   * Record of the objects created by any of the events in flight
+   */
+  struct SharedObjects {
+    /// an object created by one of the events
+    struct Object {
+      /// tag of the object
+      EventObjectTag tag;
+      /// is the object read from the input file?
+      bool should_load;
+      /// create an in-memory object of the correct type reading the input file
+      std::function<std::unique_ptr<io::BaseData>(io::Reader*)> make;
+      /// has the output file been set up to save this object?
+      bool in_output{false};
+    };
+    /// guard the record since events are created on several threads
+    std::mutex mutex;
+    /// objects in the order they were created
+    std::vector<Object> objects;
+    /// index of each object by full name
+    std::unordered_map<std::string, std::size_t> index;
+    /// paths of the objects copied into the output file in the order they started
+    std::vector<std::string> copies;
+  };
+
+  /**
+   * Record that the input object is copied into the output file
+   *
+   * @param[in] path full in-file path to the object
+   * @return true if no event has copied this object before
+   */
+  bool startCopying(const std::string& path);
+
+  /**
+   * Get the objects copied from earlier input files that are not in this one
+   *
+   * The list is updated with the objects that started being copied
+   * since the last call.
+   *
+   * @return paths to the objects missing from the input file
+   */
+  const std::vector<std::string>& missingCopies();
+
+  /// event objects being processed, indexed by their id
+  mutable std::vector<EventObject> objects_;
+  /// id of each event object by full name
+  mutable std::unordered_map<std::string, std::size_t> object_ids_;
   /// current index in the datasets
   long unsigned int i_entry_;
-  /// regular expressions determining if a dataset should be written to output
-  /// file
-  std::vector<std::pair<std::regex, bool>> drop_keep_rules_;
+  /// are we only loading the input objects when they are asked for?
+  bool lazy_;
+  /// record of created objects, shared with the other events in flight
+  std::shared_ptr<SharedObjects> shared_;
+  /// number of objects in the shared record we have synced with
+  std::size_t synced_{0};
+  /// paths of the objects we know are being copied
+  std::unordered_set<std::string> copying_;
+  /// number of copied objects in the shared record we have checked in this input file
+  std::size_t copies_checked_{0};
+  /// paths of the copied objects missing from this input file
+  std::vector<std::string> missing_copies_;
+  /// mutex guarding the input file if other events are reading it
+  std::mutex* input_mutex_{nullptr};
+  /// can several processors use this event at once?
+  bool concurrent_{false};
+  /// mutex guarding the in-memory objects from processors running at once
+  mutable std::recursive_mutex access_mutex_;
+  /**
+   * A rule determining if a dataset should be written to the output file
+   */
+  struct DropKeepRule {
+    /// regular expression the full name of the dataset must match
+    std::regex regex;
+    /// lower case literal text that the full name must start with to match
+    std::string prefix;
+    /// should the matching datasets be kept?
+    bool keep;
+  };
+  /// rules determining if a dataset should be written to output file
+  std::vector<DropKeepRule> drop_keep_rules_;
+  /// decision of the rules for each full name, empty if no rule applies
+  mutable std::unordered_map<std::string, std::optional<bool>> keep_decisions_;
   /// list of objects available to us either on disk or newly created
   std::vector<EventObjectTag> available_objects_;
+  /// full in-file path to each of the available objects
+  std::vector<std::string> available_paths_;
+  /// has each available object been checked for being the first copy in this input file?
+  std::vector<bool> copy_started_;
+  /// indices of the available objects by name
+  std::unordered_map<std::string, std::vector<std::size_t>> names_;
+  /// index of the available objects by full name (pass/name)
+  std::unordered_map<std::string, std::size_t> full_names_;
+  /// compiled patterns given to search
+  mutable std::unordered_map<std::string, std::regex> patterns_;
+  /// indices of the objects matching each search and the number of objects it has matched
+  mutable std::unordered_map<std::string, std::pair<std::size_t, std::vector<std::size_t>>> searches_;
   /// cache of known lookups when requesting an object without a pass name
   mutable std::unordered_map<std::string, std::string> known_lookups_;
+  /// objects found through handles, indexed by handle id
+  mutable std::vector<HandleSlot> handles_;
 };  // Event
 
 }  // namespace fire
@@ -0,0 +1,83 @@
+#ifndef FIRE_EVENTHANDLE_H
+#define FIRE_EVENTHANDLE_H
+
+#include <cstddef>
+#include <string>
+
+namespace fire {
+
+/**
+ * Take the next id for an event handle
+ *
+ * All types of handles take their ids from the same counter.
+ *
+ * @return new handle id
+ */
+std::size_t nextEventHandleId();
+
+/**
+ * Handle to an event object that is looked up once
+ *
+ * A processor holds a handle for each of the objects it gets or adds
+ * (usually as a member) and passes it to Event::get, Event::tryGet,
+ * or Event::add instead of the object name. The first time a handle
+ * is used with an event, the event looks up the object by its name like
+ * it does for the other overloads and remembers it under the handle's
+ * id. From then on, the event goes straight to the in-memory object
+ * without building names, searching the available objects, or checking
+ * the type again.
+ *
+ * Since the lookups are remembered by the event, the same handle can be
+ * used with all of the events a processor sees, even when the processor
+ * is shared between several events in flight.
+ *
+ * @note Each handle takes a new id, so handles should be created once
+ * (e.g. in the constructor or onProcessStart) and not for each event.
+ *
+ * @tparam DataType type of the event object
+ */
+template <typename DataType>
+class EventHandle {
+ public:
+  /**
+   * Create a handle to an event object
+   *
+   * The pass is only used when getting the object, objects are
+   * always added with the pass of the current process.
+   *
+   * @param[in] name name of the event object
+   * @param[in] pass optional pass name of the event object to get
+   */
+  EventHandle(const std::string& name, const std::string& pass = "")
+      : name_{name}, pass_{pass}, id_{nextEventHandleId()} {}
+
+  /**
+   * Get the name of the event object
+   * @return name of event object
+   */
+  const std::string& name() const { return name_; }
+
+  /**
+   * Get the pass of the event object
+   * @return pass name, empty if it is deduced
+   */
+  const std::string& pass() const { return pass_; }
+
+  /**
+   * Get the id the events remember the object under
+   * @return id of handle
+   */
+  std::size_t id() const { return id_; }
+
+ private:
+  /// name of event object
+  std::string name_;
+  /// pass of event object, empty if it is deduced
+  std::string pass_;
+  /// id unique to this handle
+  std::size_t id_;
+};  // EventHandle
+
+}  // namespace fire
+
+#endif  // FIRE_EVENTHANDLE_H
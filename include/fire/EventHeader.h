@@ -294,6 +294,14 @@ class Data<ldmx::EventHeader> : public AbstractData<ldmx::EventHeader> {
    */
   void load(h5::Reader& r) final override;
 
+  /**
+   * copied from general Data class
+   *
+   * @param[in] r h5::Reader to seek within
+   * @param[in] i_row index of row for the next load to read
+   */
+  void seek(h5::Reader& r, std::size_t i_row) final override;
+
   /**
    * copied from general Data class
    *
@@ -1,8 +1,16 @@
 #ifndef FIRE_PROCESS_H
 #define FIRE_PROCESS_H
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+
 #include "fire/logging/Logger.h"
+#include "fire/io/IOThread.h"
 #include "fire/StorageControl.h"
+#include "fire/Timing.h"
 #include "fire/Conditions.h"
 #include "fire/Event.h"
 #include "fire/Processor.h"
@@ -27,8 +35,8 @@ class Process {
    * Currently, the order of construction is given below.
    * I skip listing any types provided by STL.
    * - The output file as a h5::Writer
-   * - the Event bus
-   * - StorageControl system
+   * - the conditions system and the processors
+   * - the event slots, each with an Event bus and StorageControl system
    *
    * After these initial constructions, the logging is opened.
    *
@@ -43,6 +51,22 @@ class Process {
    * providers and processors, so we then construct the conditions system
    * and the sequence of processors (in order).
    *
+   * If there are more `threads` than one, we create twice as many
+   * event slots as threads, each with its own Event, StorageControl,
+   * and copies of the processors (except those that are threadSafe).
+   *
+   * If `timing` is enabled, we add the timers of the processors and of
+   * loading and saving events (see Timing). The output file adds the
+   * timers of writing to disk (see io::Writer::time). The timing summary is
+   * printed and written into the output file at the end of the run.
+   * If `counters` is enabled, the timers also count the performance
+   * counters of each call (see Timing) and the timing is enabled with them.
+   *
+   * If there is a `trace_file`, we open the io::Trace so that the spans
+   * of every `trace_every` events and of the disk operations are written
+   * to it as a timeline at the end of the run.
+   *
+   * @throws Exception if `trace_every` is less than one
    * @throws Exception if there is no sequence and the configuration
    *  does not have a parameter named 'testing' set to true.
    *
@@ -84,6 +108,13 @@ class Process {
    * in the input file(s) or the event_limit_ if it is provided
    * and lower than the number in the input files.
    *
+   * Only the entries from first_entry_ up to last_entry_ are processed
+   * if they are provided. These entries are counted across all of the
+   * input files as if they were one, so a large input set can be shared
+   * among many jobs without splitting the files. The files before the
+   * first entry are skipped entirely and the first entry is reached
+   * by seeking within its file instead of reading the ones before it.
+   *
    * All of the run headers from the input files are loaded into
    * an in-memory cache which is then dumped to the output file
    * at the end of processing all input files.
@@ -91,25 +122,77 @@ class Process {
    * The event headers are loaded from the input files in
    * the same manner as other event objects.
    *
+   * ## Several Threads
+   * With more than one thread, the events are processed on a pool of
+   * worker threads while this thread reads the input and saves the
+   * output. An event is loaded into a free slot and handed to the
+   * workers, and finished events are saved in the order they were
+   * read (or generated) unless `ordered_output` is false, in which case
+   * they are saved as soon as they finish. Before a new run starts,
+   * all of the events in flight are finished so that the processors
+   * and conditions see the runs one at a time as before.
+   *
    * @see newRun for how new runs are handled
    * @see process for how individual events are processed
    */
   void run(); 
 
+  /**
+   * A range of entries in one of the input files
+   */
+  struct EntryRange {
+    /// index of the file in the list of input files
+    std::size_t i_file;
+    /// first entry in the range
+    std::size_t first;
+    /// one past the last entry in the range, clamped to the entries in the file
+    std::size_t last;
+  };
+
+  /**
+   * Function giving the next range of entries to process
+   *
+   * It fills the input range and returns true,
+   * or it returns false if there are no more ranges.
+   */
+  using RangeSource = std::function<bool(EntryRange&)>;
+
+  /**
+   * Do the processing run over the ranges of entries from the source
+   *
+   * This is the same as run except that the input files are processed
+   * in the ranges of entries given by the source instead of from start
+   * to finish. An input file stays open while the ranges are in it and
+   * entries in between the ranges are skipped by seeking the input file.
+   * The source is not used in production mode.
+   *
+   * @throws Exception if a range skips entries in a file that cannot seek
+   * @param[in] next_range source of the ranges of entries to process
+   */
+  void run(const RangeSource& next_range);
+
   /**
    * Get a constant reference to the event header
+   *
+   * This is the header of the event being processed
+   * on the calling thread.
+   *
    * @return const reference to event header
    */
   const EventHeader& eventHeader() const {
-    return event_.header();
+    return slot().event.header();
   }
 
   /**
    * Get a non-constant reference to the event header
+   *
+   * This is the header of the event being processed
+   * on the calling thread.
+   *
    * @return reference to event header
    */
   EventHeader& eventHeader() {
-    return event_.header();
+    return slot().event.header();
   }
 
   /**
@@ -141,6 +224,9 @@ class Process {
    * @see Processor::setStorageHint for how user Processors are
    *    supposed to call this function.
    *
+   * The hint is given to the StorageControl of the event
+   * being processed on the calling thread.
+   *
    * @param[in] hint hint to storage on what to do with this event
    * @param[in] purpose reason for this hint
    * @param[in] processor processor from which this hint came from
@@ -150,7 +236,39 @@ class Process {
       const std::string& purpose,
       const std::string& processor
       ) {
-    storage_control_.addHint(hint,purpose,processor);
+    slot().storage_control.addHint(hint,purpose,processor);
+  }
+
+  /**
+   * Add a storage control hint with a token
+   *
+   * @see Processor::storageHintToken for how the token is made
+   *
+   * @param[in] hint hint to storage on what to do with this event
+   * @param[in] token token of the processor and purpose giving the hint
+   */
+  void addStorageControlHint(
+      StorageControl::Hint hint,
+      const StorageControl::HintToken& token
+      ) {
+    slot().storage_control.addHint(hint,token);
+  }
+
+  /**
+   * Get the token for storage control hints from a processor
+   *
+   * The storage controls of all the events in flight share their
+   * tokens, so we can get the token from any of them.
+   *
+   * @param[in] purpose reason for the hints
+   * @param[in] processor processor the hints come from
+   * @return token to give the hints with
+   */
+  StorageControl::HintToken storageControlToken(
+      const std::string& purpose,
+      const std::string& processor
+      ) {
+    return slots_.front()->storage_control.token(purpose,processor);
   }
 
   /**
@@ -166,6 +284,137 @@ class Process {
   }
 
  private:
+  /**
+   * An event in flight along with what is needed to process it
+   */
+  struct EventSlot {
+    /**
+     * Create the event and storage control of the slot
+     *
+     * @param[in] output_file handle to the output file
+     * @param[in] configuration complete processing configuration
+     */
+    EventSlot(io::Writer* output_file, const config::Parameters& configuration);
+    /// event bus for this slot
+    Event event;
+    /// object used to determine if this event should be saved or not
+    StorageControl storage_control;
+    /// the sequence of processors to run on this event
+    std::vector<Processor*> sequence;
+    /// number of events processed before this one, for the status message
+    std::size_t n_processed{0};
+    /// has the processing of this event finished? (guarded by slot_mutex_)
+    bool done{false};
+    /// was this event processed without being aborted?
+    bool processed{false};
+    /// exception thrown while processing this event
+    std::exception_ptr error;
+  };
+
+  /**
+   * Get the slot of the event being processed on the calling thread
+   *
+   * Outside of the worker threads, this is the first slot when
+   * processing serially or the slot being prepared otherwise.
+   *
+   * @return reference to slot for this thread
+   */
+  EventSlot& slot() const {
+    return current_slot_ ? *current_slot_ : *slots_.front();
+  }
+
+  /**
+   * Open the input file and get ready to process its entries
+   *
+   * The runs in the file are loaded into the input cache, the
+   * processors are told the file is open, and the input file
+   * is attached to the events.
+   *
+   * @param[in] i_file index of the file in the input files
+   * @param[in,out] input_runs cache of the runs in the input files
+   * @return handle to the opened input file
+   */
+  std::unique_ptr<io::Reader> openInput(std::size_t i_file,
+      std::unordered_map<int, RunHeader>& input_runs);
+
+  /**
+   * Finish processing the entries of the input file
+   *
+   * We drain the events in flight and finish copying the kept objects
+   * before the processors are told the file is closed.
+   *
+   * @param[in] input_file the input file being closed
+   */
+  void closeInput(io::Reader& input_file);
+
+  /**
+   * Get a slot that is not being processed
+   *
+   * If all of the slots are in flight, we wait for one to finish
+   * and save it (see retire) or, when pipelined, for the writer
+   * thread to give one back (see store). Any objects created by
+   * the other events in flight are created in the slot (Event::sync).
+   *
+   * @throws any exception thrown while processing or saving an event
+   *    on the writer thread
+   * @return reference to slot ready for a new event
+   */
+  EventSlot& acquire();
+
+  /**
+   * Process the event in the input slot
+   *
+   * We print the status message and then the sequence is run up
+   * to max_tries times until the event is not aborted. Serially, we do this right away and then finish the
+   * event. Otherwise, the processing is given to the worker threads.
+   * When pipelined, saving the event is then given to the writer thread,
+   * in dispatch order if the output is ordered and as soon as the
+   * processing is done otherwise.
+   *
+   * @param[in] slot slot with the event loaded or generated
+   * @param[in] max_tries maximum number of attempts to process the event
+   */
+  void dispatch(EventSlot& slot, int max_tries);
+
+  /**
+   * Wait for an event in flight to finish and then save it
+   *
+   * We wait for the oldest event in flight if the output is ordered
+   * and for any event otherwise.
+   *
+   * @throws any exception thrown while processing the event
+   */
+  void retire();
+
+  /**
+   * Wait for all of the events in flight to finish and save them
+   *
+   * @throws any exception thrown while processing or saving an event
+   */
+  void drain();
+
+  /**
+   * Save the event in the input slot on the writer thread
+   *
+   * We wait for the processing of the event to be done, finish it,
+   * and then give the slot back to acquire. Any exception is kept
+   * so that it is re-thrown on the main thread.
+   *
+   * @param[in] slot slot holding event being processed
+   */
+  void store(EventSlot& slot);
+
+  /**
+   * Save the event in the input slot if it should be kept
+   *
+   * We move the event to the next entry after saving it.
+   *
+   * @see Event::save for how the event saves in-memory objects to disk
+   * @see StorageControl::keepEvent for how the keep decision is made
+   * @param[in] slot slot holding event that finished processing
+   */
+  void finish(EventSlot& slot);
+
   /**
    * Method to declare a new run is beginning
    *
@@ -191,29 +440,58 @@ class Process {
   /**
    * process the event
    *
-   * If the event is not aborted, the storage controller is given the choice
-   * on whether the event should be kept. If it decides to "keep" the event,
-   * then the event is saved to the output file 
-   *
    * We first reset the event state via StorageControl::resetEventState
    * and then we go through the processors in order. If any of the processors
-   * abort the event, we return false, otherwise we check with the storage
-   * system on whether this event should be kept. Before leaving
-   * **and after saving**, we call Event::next to move the event bus 
-   * to the next event.
+   * abort the event, we return false, otherwise we return true so that
+   * the storage system is given the choice on whether this event should
+   * be kept when the event is finished.
    *
-   * @see Event::save for how the event saves in-memory objects to disk
-   * @see StorageControl::keepEvent for how the keep decision is made
-   * @param[in] n_events_processed number of events we have already processed
-   *    only used for printing out a status message
+   * @param[in] slot slot holding the event to process
    * @return true if event was successfully processed (i.e. not aborted)
    */
-  bool process(const std::size_t& n_events_processed);
+  bool process(EventSlot& slot);
+
+  /**
+   * Run the sequence on the event with independent processors at once
+   *
+   * Each processor starts once the processors it depends on have
+   * finished (see dependents_). The ready processors are given to the
+   * task threads except for one which we run on the calling thread.
+   * Once a processor throws (including aborting the event), no more are
+   * started and we wait for the running ones before re-throwing the
+   * exception from the earliest processor in the sequence, which is the
+   * one that would have been thrown if the sequence was run in order.
+   *
+   * @note Unlike running in order, processors later in the sequence that
+   * do not depend on the one that threw may have already run. Their
+   * changes to the event and their storage hints are not undone.
+   *
+   * @param[in] slot slot holding the event to process
+   */
+  void runConcurrently(EventSlot& slot);
+
+  /**
+   * Report the timing summary
+   *
+   * The summary is printed as a table to the log and
+   * written as a table into the output file (see Timing::NAME).
+   * If counting, the rates of the counters per call or per thousand
+   * instructions are printed as a second table.
+   *
+   * @throws Exception if the table cannot be written
+   */
+  void reportTiming();
 
  private:
   /// limit on number of events to process
   int event_limit_;
 
+  /// first entry of the input files to process
+  long first_entry_;
+
+  /// one past the last entry of the input files to process, negative for all of them
+  long last_entry_;
+
   /// frequency with which event info is printed
   int log_frequency_;
 
@@ -226,20 +504,93 @@ class Process {
   /// input file listing, PRODUCTION MODE if empty
   std::vector<std::string> input_files_;
 
+  /// parameters passed to the readers when opening the input files
+  config::Parameters reader_parameters_;
+
+  /// number of threads processing events
+  int threads_;
+
+  /// save the events in the order they were read or generated?
+  bool ordered_output_;
+
+  /// save the events on a separate thread from reading them?
+  bool pipeline_;
+
+  /// timers of the parts of processing, only if timing is enabled,
+  /// the output file records into them until it is closed
+  std::unique_ptr<Timing> timing_;
+
   /// output file we are writing to
   io::Writer output_file_;
 
-  /// the sequence of processors to run
-  std::vector<std::unique_ptr<Processor>> sequence_;
-
-  /// object used to determine if an event should be saved or not
-  StorageControl storage_control_;
+  /// all of the processors, including the copies for each slot
+  std::vector<std::unique_ptr<Processor>> processors_;
 
   /// handle to conditions system
   std::unique_ptr<Conditions> conditions_;
 
-  /// event object
-  Event event_;
+  /// the events that can be in flight at once, only one if serial
+  std::vector<std::unique_ptr<EventSlot>> slots_;
+
+  /// slots that are not being processed
+  std::vector<EventSlot*> free_slots_;
+
+  /// slots being processed in the order they were dispatched
+  std::deque<EventSlot*> in_flight_;
+
+  /// mutex guarding the input file from the slots reading it at once
+  std::mutex input_mutex_;
+
+  /// mutex guarding the done flags of the slots and the pipeline state below
+  std::mutex slot_mutex_;
+
+  /// signal that a slot has finished processing
+  std::condition_variable slot_done_;
+
+  /// signal that the writer thread has given back a slot
+  std::condition_variable slot_free_;
+
+  /// number of slots given to the writer thread and not given back yet
+  std::size_t in_pipeline_{0};
+
+  /// first exception thrown on the writer thread
+  std::exception_ptr pipeline_error_;
+
+  /// threads processing the events, only if more than one slot
+  std::unique_ptr<io::IOThread> workers_;
+
+  /// thread saving the events, only if pipelined
+  std::unique_ptr<io::IOThread> writer_;
+
+  /**
+   * processors later in the sequence that must wait for each processor
+   *
+   * A processor depends on an earlier one if either has not declared
+   * the objects it uses or if one produces an object the other
+   * consumes or produces. Only filled if running processors at once.
+   */
+  std::vector<std::vector<std::size_t>> dependents_;
+
+  /// number of earlier processors each processor waits for
+  std::vector<std::size_t> num_dependencies_;
+
+  /// threads running independent processors of an event, only if more than one
+  std::unique_ptr<io::IOThread> tasks_;
+
+  /// timer of the process method for each processor in the sequence
+  std::vector<std::size_t> process_timers_;
+
+  /// timer of onNewRun for each of the processors
+  std::vector<std::size_t> run_timers_;
+
+  /// timer of onFileOpen for each of the processors
+  std::vector<std::size_t> file_timers_;
+
+  /// timers of loading and saving events
+  std::size_t load_timer_{0}, save_timer_{0};
+
+  /// the slot being processed on the current thread
+  static thread_local EventSlot* current_slot_;
 
   /// the current run header
   RunHeader* run_header_;
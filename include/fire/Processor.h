@@ -150,6 +150,44 @@ class Processor {
    */
   const std::string &getName() const { return name_; }
 
+  /**
+   * Can this processor handle several events at once?
+   *
+   * When the Process is running with more than one thread, processors
+   * that are not thread safe (the default) are created once for each
+   * event in flight with the same parameters. Processors that return
+   * true here are created once and shared, so their process method
+   * must be safe to call on several threads at once (including any
+   * logging they do).
+   *
+   * @return true if a single instance can be shared among threads
+   */
+  virtual bool threadSafe() const { return false; }
+
+  /**
+   * Has this processor declared the event objects it uses?
+   *
+   * Processors that have not declared what they consume and produce
+   * are run only after all of the processors before them in the
+   * sequence have finished and before any of the processors after them
+   * have started, exactly as if the sequence was run in order.
+   *
+   * @see consumes and produces for declaring the event objects
+   * @return true if the processor has declared its event objects
+   */
+  bool declaredObjects() const { return declared_objects_; }
+
+  /**
+   * Get the names of the event objects this processor reads
+   * @return list of object names given to Event::get
+   */
+  const std::vector<std::string> &consumed() const { return consumed_; }
+
+  /**
+   * Get the names of the event objects this processor adds
+   * @return list of object names given to Event::add
+   */
+  const std::vector<std::string> &produced() const { return produced_; }
 
   /**
    * have the derived processors do what they need to do
@@ -352,6 +390,62 @@ class Processor {
   void setStorageHint(StorageControl::Hint hint,
                       const std::string &purpose = "") const;
 
+  /**
+   * Mark the current event as having the given storage control hint
+   * with a token from storageHintToken
+   *
+   * This skips looking up if the storage control listens to
+   * this processor and purpose on every event.
+   *
+   * @param[in] hint The storage control hint to apply for the given event
+   * @param[in] token token of this processor and the purpose of the hint
+   */
+  void setStorageHint(StorageControl::Hint hint,
+                      const StorageControl::HintToken& token) const;
+
+  /**
+   * Get a token to give storage control hints with
+   *
+   * This is meant to be called once (e.g. in onProcessStart) for each
+   * purpose the processor gives hints for and it needs the Process to be
+   * attached, so it cannot be called in the constructor.
+   *
+   * @param[in] purpose A purpose string which can be used in the skim control
+   * configuration to select which hints to "listen" to
+   * @return token to give hints with
+   */
+  StorageControl::HintToken storageHintToken(const std::string &purpose = "") const;
+
+  /**
+   * Declare that this processor reads the input event object
+   *
+   * When the Process runs the processors of an event concurrently,
+   * this processor waits for the earlier processors in the sequence
+   * that produce the object and the later processors producing it
+   * wait for this one. This is meant to be called in the constructor
+   * and it is the same as listing the object in the 'consumes' parameter.
+   *
+   * @param[in] name name of the object as given to Event::get
+   */
+  void consumes(const std::string &name) {
+    consumed_.push_back(name);
+    declared_objects_ = true;
+  }
+
+  /**
+   * Declare that this processor adds the input event object
+   *
+   * Like consumes, this is used to order this processor after earlier
+   * processors consuming or producing the object and before later ones.
+   * It is the same as listing the object in the 'produces' parameter.
+   *
+   * @param[in] name name of the object as given to Event::add
+   */
+  void produces(const std::string &name) {
+    produced_.push_back(name);
+    declared_objects_ = true;
+  }
+
 
   /**
    * Abort the event immediately.
@@ -384,6 +478,15 @@ class Processor {
   /** The name of the Processor. */
   std::string name_;
 
+  /// names of the event objects this processor reads
+  std::vector<std::string> consumed_;
+
+  /// names of the event objects this processor adds
+  std::vector<std::string> produced_;
+
+  /// have the objects this processor uses been declared?
+  bool declared_objects_;
+
   /// Handle to current process
   Process *process_{nullptr};
 };
@@ -264,6 +264,14 @@ class Data<ldmx::RunHeader> : public AbstractData<ldmx::RunHeader> {
    */
   void load(h5::Reader& r) final override;
 
+  /**
+   * copied from general Data class
+   *
+   * @param[in] r h5::Reader to seek within
+   * @param[in] i_row index of row for the next load to read
+   */
+  void seek(h5::Reader& r, std::size_t i_row) final override;
+
   /**
    * copied from general Data class
    *
@@ -1,8 +1,11 @@
 #ifndef FIRE_STORAGECONTROL_H_
 #define FIRE_STORAGECONTROL_H_
 
+#include <memory>
+#include <mutex>
 #include <regex>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "fire/config/Parameters.h"
@@ -17,6 +20,12 @@ namespace fire {
  * StorageControl object until the end of the event. At that
  * point, the process queries the StorageControl to determine if
  * the event should be stored in the output file.
+ *
+ * Whether the listening rules consider the hints from a processor and
+ * purpose is only decided once. Processors can get a HintToken holding
+ * this decision so their hints skip the strings entirely, and the hints
+ * given with strings look the decision up. The keep and drop votes from
+ * each processor and purpose are counted for a report at the end of the run.
  */
 class StorageControl {
  public:
@@ -36,6 +45,34 @@ class StorageControl {
     MustDrop = 20
   };  // enum Hint
 
+  /**
+   * A processor and purpose that have been checked against the listening rules
+   *
+   * @see Processor::storageHintToken for how processors get one
+   */
+  struct HintToken {
+    /// index of the processor and purpose among those giving hints
+    std::size_t index;
+    /// are the hints from this processor and purpose considered?
+    bool listened;
+  };
+
+  /**
+   * The votes given by a processor with a purpose
+   */
+  struct Votes {
+    /// name of processor giving the hints
+    std::string processor;
+    /// purpose of the hints
+    std::string purpose;
+    /// are the hints considered?
+    bool listened;
+    /// number of hints to keep the event
+    std::size_t keep{0};
+    /// number of hints to drop the event
+    std::size_t drop{0};
+  };
+
  public:
   /**
    * Configure the various options for how the storage contol behaves.
@@ -53,6 +90,31 @@ class StorageControl {
    */
   void resetEventState();
 
+  /**
+   * Share the processors and purposes giving hints with another storage control
+   *
+   * The storage controls of the events in flight share them so that
+   * a token is the same for all of them.
+   *
+   * @note This must be called before any hints are given.
+   *
+   * @param[in] other storage control to share with
+   */
+  void shareWith(const StorageControl& other);
+
+  /**
+   * Get the token for hints from a processor with a purpose
+   *
+   * The processor and purpose are matched against the listening rules
+   * the first time any of the sharing storage controls see them.
+   *
+   * @param[in] purpose A purpose string which can be used in the skim control
+   * configuration
+   * @param[in] processor_name Name of the event processor
+   * @return token to give hints with
+   */
+  HintToken token(const std::string& purpose, const std::string& processor_name);
+
   /**
    * Add a storage hint for a given processor
    *
@@ -62,6 +124,10 @@ class StorageControl {
    * @note This means if no listing rules are provided then no storage
    * hints are considered!
    *
+   * Hints can be added by processors running on the same event at once.
+   * The token of each processor and purpose is remembered, so the
+   * listening rules are only matched the first time they give a hint.
+   *
    * @param[in] hint The storage control hint to apply for the given event
    * @param[in] purpose A purpose string which can be used in the skim control
    * configuration
@@ -70,6 +136,27 @@ class StorageControl {
   void addHint(Hint hint, const std::string& purpose,
                const std::string& processor_name);
 
+  /**
+   * Add a storage hint with a token
+   *
+   * This is the same as giving the hint with the processor name
+   * and purpose the token was made for, without looking them up.
+   *
+   * @param[in] hint The storage control hint to apply for the given event
+   * @param[in] token token of the processor and purpose giving the hint
+   */
+  void addHint(Hint hint, const HintToken& token);
+
+  /**
+   * Get the votes given by each processor and purpose
+   *
+   * The votes are counted for each hint given to this storage control,
+   * whether it is listened to or not.
+   *
+   * @return votes in the order the processors and purposes gave their first hints
+   */
+  std::vector<Votes> votes() const;
+
   /**
    * Determine if the current event should be kept, based on the defined rules
    *
@@ -111,6 +198,38 @@ class StorageControl {
    * Collection of hints from the event processors
    */
   std::vector<Hint> hints_;
+
+  /**
+   * Guard the hints from processors running at once
+   */
+  mutable std::mutex hints_mutex_;
+
+  /**
+   * Processors and purposes giving hints, shared with the other events in flight
+   */
+  struct Hinters {
+    /// guard the record since events are processed on several threads
+    std::mutex mutex;
+    /// the processors and purposes in the order they gave their first hints
+    std::vector<Votes> hinters;
+    /// index of each processor and purpose
+    std::unordered_map<std::string, std::size_t> index;
+  };
+
+  /**
+   * Record of the processors and purposes giving hints
+   */
+  std::shared_ptr<Hinters> hinters_;
+
+  /**
+   * Tokens of the processors and purposes that gave hints to us
+   */
+  std::unordered_map<std::string, HintToken> tokens_;
+
+  /**
+   * Number of keep and drop votes for each token index
+   */
+  std::vector<std::pair<std::size_t, std::size_t>> counts_;
 };
 }  // namespace fire
 
@@ -0,0 +1,278 @@
+#ifndef FIRE_TIMING_H
+#define FIRE_TIMING_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "fire/io/Access.h"
+#include "fire/io/ClassVersion.h"
+#include "fire/io/Constants.h"
+
+namespace fire {
+
+/**
+ * Time spent in the different parts of processing
+ *
+ * Each part of processing we time (e.g. the process method of a processor
+ * or saving an event) has a timer that adds up the wall and CPU time of
+ * each call and counts the calls. The wall time of each call is also put
+ * into a histogram with four logarithmic buckets for each power of two
+ * nanoseconds so that we can estimate the median and the 99th percentile.
+ *
+ * The timers are all added before processing starts and then they
+ * can be recorded into from several threads at once.
+ *
+ * If counters are enabled, each call also adds up the hardware
+ * performance counters of its thread (cycles, instructions, cache misses,
+ * and branch misses) read with the Linux perf_event_open system call.
+ * They are only counted in user space. If the counters cannot be opened
+ * (e.g. they are not permitted in a container), only the page faults and
+ * context switches from getrusage are counted.
+ */
+class Timing {
+ public:
+  /// the counters added up for each call if enabled
+  enum Counter {
+    CYCLES,
+    INSTRUCTIONS,
+    CACHE_MISSES,
+    BRANCH_MISSES,
+    PAGE_FAULTS,
+    CONTEXT_SWITCHES,
+    NUM_COUNTERS
+  };
+
+  /// a value of each of the counters
+  using Counts = std::array<std::uint64_t, NUM_COUNTERS>;
+
+  /**
+   * Create the timing without any timers
+   *
+   * @param[in] counters count the performance counters of each call
+   */
+  explicit Timing(bool counters = false) : counters_{counters} {}
+
+  /**
+   * Name of the table of timers in the output file
+   *
+   * The table is in the group of the run headers.
+   */
+  inline static const std::string NAME = io::constants::RUN_HEADER_NAME + "/timing";
+
+  /**
+   * Summary of a timer, one row of the table in the output file
+   */
+  struct Summary {
+    /// name of the timer
+    std::string name;
+    /// number of calls
+    long int calls;
+    /// total wall time [s]
+    double wall;
+    /// total CPU time [s]
+    double cpu;
+    /// median wall time of a call [s]
+    double p50;
+    /// 99th percentile of the wall time of a call [s]
+    double p99;
+    /// longest wall time of a call [s]
+    double max;
+    /// total of each of the counters, -1 if not counted
+    std::array<long int, NUM_COUNTERS> counts;
+
+    /// version of the table
+    fire_class_version(2);
+
+    /// reset to an empty row
+    void clear() {
+      name.clear();
+      calls = 0;
+      wall = cpu = p50 = p99 = max = 0.;
+      counts.fill(-1);
+    }
+
+   private:
+    /// let the serialization attach us
+    friend class fire::io::access;
+
+    /**
+     * Attach the columns of the table
+     * @param[in] d data set to attach to
+     */
+    template <typename DataSet>
+    void attach(DataSet& d) {
+      d.attach("name", name);
+      d.attach("calls", calls);
+      d.attach("wall", wall);
+      d.attach("cpu", cpu);
+      d.attach("p50", p50);
+      d.attach("p99", p99);
+      d.attach("max", max);
+      // the counters are not in tables before version 2
+      static const std::array<std::string, NUM_COUNTERS> counters{"cycles", "instructions",
+        "cache_misses", "branch_misses", "page_faults", "context_switches"};
+      for (std::size_t i{0}; i < NUM_COUNTERS; i++) {
+        if (d.version() < 2) d.attach(counters[i], counts[i], DataSet::SaveLoad::SaveOnly);
+        else d.attach(counters[i], counts[i]);
+      }
+    }
+  };
+
+  /**
+   * Time the enclosing scope
+   *
+   * The times are recorded when we are destructed, so this also
+   * counts calls that leave by throwing an exception. Nothing is
+   * measured if timing is disabled (a null Timing).
+   */
+  class Scope {
+   public:
+    /**
+     * Start timing
+     *
+     * @param[in] timing timers to record into, nullptr if disabled
+     * @param[in] id id of the timer to record into
+     */
+    Scope(Timing* timing, std::size_t id);
+
+    /**
+     * Stop timing and record the times
+     */
+    ~Scope();
+
+    /// the times are only recorded once
+    Scope(const Scope&) = delete;
+    /// the times are only recorded once
+    Scope& operator=(const Scope&) = delete;
+
+   private:
+    /// timers to record into
+    Timing* timing_;
+    /// id of timer
+    std::size_t id_;
+    /// wall clock when we started
+    std::chrono::steady_clock::time_point wall_start_;
+    /// CPU time of the thread when we started [ns]
+    std::uint64_t cpu_start_;
+    /// counters of the thread when we started, if counting
+    Counts counts_start_;
+  };
+
+  /**
+   * Add a timer
+   *
+   * Adding a timer with the same name as another gives the
+   * same timer so that copies of a processor are timed together.
+   *
+   * @param[in] name name of timer
+   * @return id of the timer
+   */
+  std::size_t add(const std::string& name);
+
+  /**
+   * Record the times of a call
+   *
+   * @param[in] id id of the timer
+   * @param[in] wall_ns wall time of the call [ns]
+   * @param[in] cpu_ns CPU time of the call [ns]
+   * @param[in] counts counters of the call, nullptr if not counted
+   */
+  void record(std::size_t id, std::uint64_t wall_ns, std::uint64_t cpu_ns,
+              const Counts* counts = nullptr);
+
+  /**
+   * Are we counting the performance counters of each call?
+   * @return true if the counters are enabled
+   */
+  bool counters() const { return counters_; }
+
+  /**
+   * Were the hardware counters available?
+   * @return true if the hardware counters could be read on every thread counted
+   */
+  bool hardwareCounters() const { return hardware_.load(); }
+
+  /**
+   * Summarize the timers in the order they were added
+   *
+   * @return summary of each timer
+   */
+  std::vector<Summary> summary() const;
+
+  /**
+   * Get the CPU time used by the calling thread
+   *
+   * @return CPU time [ns]
+   */
+  static std::uint64_t threadCPUTime();
+
+  /**
+   * Get the counters of the calling thread
+   *
+   * The hardware counters of each thread are opened the first time
+   * they are read on it and they are left zero if they cannot be opened.
+   *
+   * @param[out] counts counters of the thread
+   * @return true if the hardware counters were read
+   */
+  static bool threadCounts(Counts& counts);
+
+ private:
+  /// number of buckets in the histograms, enough for any 64-bit number of nanoseconds
+  static const std::size_t NUM_BUCKETS{256};
+
+  /**
+   * A timer recorded into from several threads at once
+   */
+  struct Timer {
+    /// name of timer
+    std::string name;
+    /// number of calls
+    std::atomic<std::uint64_t> calls{0};
+    /// total wall time [ns]
+    std::atomic<std::uint64_t> wall{0};
+    /// total CPU time [ns]
+    std::atomic<std::uint64_t> cpu{0};
+    /// longest wall time [ns]
+    std::atomic<std::uint64_t> max{0};
+    /// number of calls in each bucket of wall time
+    std::array<std::atomic<std::uint64_t>, NUM_BUCKETS> buckets{};
+    /// total of each of the counters
+    std::array<std::atomic<std::uint64_t>, NUM_COUNTERS> counts{};
+  };
+
+  /**
+   * Get the histogram bucket of a wall time
+   *
+   * @param[in] ns wall time [ns]
+   * @return index of bucket
+   */
+  static std::size_t bucket(std::uint64_t ns);
+
+  /**
+   * Get the upper edge of a histogram bucket
+   *
+   * @param[in] i_bucket index of bucket
+   * @return smallest wall time after the bucket [ns]
+   */
+  static std::uint64_t upperEdge(std::size_t i_bucket);
+
+  /// are we counting the performance counters?
+  bool counters_;
+  /// could the hardware counters be read on every thread?
+  std::atomic<bool> hardware_{true};
+  /// the timers, a deque so they stay in place as they are added
+  std::deque<Timer> timers_;
+  /// id of each timer by name
+  std::unordered_map<std::string, std::size_t> ids_;
+};  // Timing
+
+}  // namespace fire
+
+#endif  // FIRE_TIMING_H
@@ -69,9 +69,12 @@ class UserReader {
    * @see io::h5::Reader for reading of H5 files
    * @see Event::setInputFile for connecting the file reader and event bus
    *
-   * Skipping the initial number of entries is done by just calling next
-   * the requested number of times. Without any objects loaded onto the
-   * event bus, this is simply moving the entry index within Event.
+   * Skipping the initial number of entries is done by seeking the
+   * event bus to the last skipped entry (Event::seek) and loading it,
+   * leaving us in the same state as calling next the requested number
+   * of times. Readers that can seek do not read the skipped entries.
+   * If more entries are skipped than are in the file, we do call next
+   * that many times so that we can wrap around.
    *
    * @param[in] fn file path to be opened
    * @param[in] n (optional) number of entries at beginning of file to skip
@@ -0,0 +1,40 @@
+#ifndef FIRE_WORKERS_H
+#define FIRE_WORKERS_H
+
+#include "fire/config/Parameters.h"
+
+namespace fire {
+
+/**
+ * Process the input files with several worker processes
+ *
+ * The input files are split into ranges of entries which are put into
+ * a work queue in shared memory. We then fork the worker processes,
+ * each running a Process of its own that takes the next range from the
+ * queue whenever it is done with the previous one. This way the workers
+ * that are faster take more of the ranges and none of them are left idle
+ * while the others finish. Since each worker is its own process, the
+ * processors do not need to be thread safe.
+ *
+ * Each worker writes its own partial output file next to the output file
+ * (with '_worker<i>' appended to the name) and its own log and trace files
+ * if there are any. Once all of the workers succeeded, the partial outputs are merged
+ * into the output file by copying all of their objects and run headers
+ * and then removed. The events in the output file are grouped by the worker
+ * that processed them and so they are not in the order of the input files.
+ *
+ * @note The input files must be able to seek (see io::Reader::canSeek)
+ * and the first_entry, last_entry and event_limit are applied to the
+ * input entries before they are split.
+ *
+ * @throws Exception if there are no input files or if one cannot seek
+ * @throws Exception if the range of entries to process is not valid
+ * @throws Exception if a worker fails, the partial outputs are kept
+ * @param[in] configuration complete processing configuration
+ * @param[in] num_workers number of worker processes to fork
+ */
+void runWorkers(const config::Parameters& configuration, int num_workers);
+
+}  // namespace fire
+
+#endif  // FIRE_WORKERS_H
@@ -52,6 +52,21 @@ class Parameters {
     add<T>(name,value);
   }
 
+  /**
+   * Set a parameter in the parameter list, replacing its value
+   * if it already exists.
+   *
+   * This is helpful when deriving a configuration from another one.
+   *
+   * @param[in] name Name of the parameter.
+   * @param[in] value The new value of the parameter.
+   * @tparam T type of parameter being set
+   */
+  template <typename T>
+  void set(const std::string& name, const T& value) {
+    parameters_[name] = value;
+  }
+
   /**
    * Check to see if a parameter exists
    *
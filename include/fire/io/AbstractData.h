@@ -48,6 +48,18 @@ class BaseData {
    */
   virtual void load(h5::Reader& f) = 0;
 
+  /**
+   * pure virtual method for moving to a row in the input file
+   *
+   * After seeking, the next load reads the row i_row of
+   * our data set(s) no matter what was loaded before.
+   * For the top-level event objects, the row is the entry index.
+   *
+   * @param[in] f h5::Reader to seek within
+   * @param[in] i_row index of row for the next load to read
+   */
+  virtual void seek(h5::Reader& f, std::size_t i_row) = 0;
+
 #ifdef fire_USE_ROOT
   /**
    * pure virtual method for loading data from the input file
@@ -132,6 +144,14 @@ class AbstractData : public BaseData {
    */
   virtual void load(h5::Reader& f) = 0;
 
+  /**
+   * pure virtual method for seeking data
+   *
+   * @param[in] f h5::Reader to seek within
+   * @param[in] i_row index of row for the next load to read
+   */
+  virtual void seek(h5::Reader& f, std::size_t i_row) = 0;
+
 #ifdef fire_USE_ROOT
   /**
    * pure virtual method for loading data from the input file
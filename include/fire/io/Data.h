@@ -1,6 +1,7 @@
 #ifndef FIRE_IO_DATA_H
 #define FIRE_IO_DATA_H
 
+#include <functional>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -135,16 +136,18 @@ class Data : public AbstractData<DataType> {
   void load(h5::Reader& f) final override try {
     for (auto& [save,load,m] : members_) if (load) m->load(f);
   } catch (const HighFive::DataSetException& e) {
-    const auto& [memt, memv] = this->save_type_;
-    const auto& [diskt, diskv] = f.type(this->path_);
-    std::stringstream ss;
-    ss << "Data at " << this->path_ << " could not be loaded into "
-        << memt  << " (version " << memv << ") from the type it was written as " 
-        << diskt << " (version " << diskv << ")\n"
-        "  Check that your implementation of attach can handle any "
-        "previous versions of your class you are trying to read.\n"
-        "  H5 Error:\n" << e.what();
-    throw Exception("BadType",ss.str(), false);
+    throw bad_type(f, e);
+  }
+
+  /**
+   * Seeking this dataset involves seeking all of the members
+   * that are loaded, each member has one row per object.
+   *
+   * @param[in] f file to seek within
+   * @param[in] i_row index of the object for the next load to read
+   */
+  void seek(h5::Reader& f, std::size_t i_row) final override {
+    for (auto& [save,load,m] : members_) if (load) m->seek(f, i_row);
   }
 
 #ifdef fire_USE_ROOT
@@ -172,6 +175,50 @@ class Data : public AbstractData<DataType> {
     for (auto& [save,load,m] : members_) if (save) m->structure(f);
   }
 
+  /**
+   * Can we save and load arrays of our type column by column?
+   *
+   * This is true if all of the attached members are atomic types
+   * stored within the object itself. Then each member is a column
+   * whose values can be gathered (or scattered) in one pass over
+   * an array of objects.
+   *
+   * @return true if save and load of spans can be used
+   */
+  bool columnar() const { return columnar_; }
+
+  /**
+   * Load the next n objects into an array, one member at a time
+   *
+   * This must only be called if columnar is true. The on-disk format
+   * is the same as loading one object at a time.
+   *
+   * @throw Exception if HighFive is unable to load any of the members.
+   *
+   * @param[in] f file to load from
+   * @param[out] objs pointer to first object in array to load into
+   * @param[in] n number of objects to load
+   */
+  void load(h5::Reader& f, DataType* objs, std::size_t n) try {
+    for (auto& [save,load,column] : columns_) if (load) column.load(f, objs, n);
+  } catch (const HighFive::DataSetException& e) {
+    throw bad_type(f, e);
+  }
+
+  /**
+   * Save n objects from an array, one member at a time
+   *
+   * This must only be called if columnar is true. The on-disk format
+   * is the same as saving one object at a time.
+   *
+   * @param[in] f file to save to
+   * @param[in] objs pointer to first object in array to save
+   * @param[in] n number of objects to save
+   */
+  void save(Writer& f, const DataType* objs, std::size_t n) {
+    for (auto& [save,load,column] : columns_) if (save) column.save(f, objs, n);
+  }
+
   /**
    * Attach a member object from the our data handle
    *
@@ -198,8 +245,30 @@ class Data : public AbstractData<DataType> {
     if (sl == SaveLoad::LoadOnly) load = true;
     else if (sl == SaveLoad::SaveOnly) { save = true; input_file = nullptr; }
     else { save = true; load = true; }
-    members_.push_back(std::make_tuple(save, load,
-        std::make_unique<Data<MemberType>>(this->path_ + "/" + name, input_file, &m)));
+    auto member{std::make_unique<Data<MemberType>>(this->path_ + "/" + name, input_file, &m)};
+    // atomic members within the object can be accessed as a column
+    // of an array of objects by their offset from the object's address
+    std::ptrdiff_t offset{reinterpret_cast<char*>(&m) 
+                            - reinterpret_cast<char*>(this->handle_)};
+    if constexpr (is_atomic_v<MemberType>) {
+      if (offset >= 0 and offset + sizeof(MemberType) <= sizeof(DataType)) {
+        Data<MemberType>* d{member.get()};
+        columns_.push_back(std::make_tuple(save, load, Column{
+            [d,offset](Writer& f, const DataType* objs, std::size_t n) {
+              d->save(f, reinterpret_cast<const MemberType*>(
+                  reinterpret_cast<const char*>(objs) + offset), n, sizeof(DataType));
+            },
+            [d,offset](h5::Reader& f, DataType* objs, std::size_t n) {
+              d->load(f, reinterpret_cast<MemberType*>(
+                  reinterpret_cast<char*>(objs) + offset), n, sizeof(DataType));
+            }}));
+      } else {
+        columnar_ = false;
+      }
+    } else {
+      columnar_ = false;
+    }
+    members_.push_back(std::make_tuple(save, load, std::move(member)));
   }
 
   /**
@@ -221,6 +290,40 @@ class Data : public AbstractData<DataType> {
     attach(new_name,m,SaveLoad::SaveOnly);
   }
 
+ private:
+  /**
+   * Build the exception for a member that failed to load
+   *
+   * We detail to the user which class is causing the read issue
+   * and what type it was written as.
+   *
+   * @param[in] f file we were loading from
+   * @param[in] e exception HighFive threw while loading
+   * @return exception to throw
+   */
+  Exception bad_type(h5::Reader& f, const HighFive::DataSetException& e) const {
+    const auto& [memt, memv] = this->save_type_;
+    const auto& [diskt, diskv] = f.type(this->path_);
+    std::stringstream ss;
+    ss << "Data at " << this->path_ << " could not be loaded into "
+        << memt  << " (version " << memv << ") from the type it was written as " 
+        << diskt << " (version " << diskv << ")\n"
+        "  Check that your implementation of attach can handle any "
+        "previous versions of your class you are trying to read.\n"
+        "  H5 Error:\n" << e.what();
+    return Exception("BadType",ss.str(), false);
+  }
+
+  /**
+   * Saving and loading of a single atomic member across an array of objects
+   */
+  struct Column {
+    /// gather the member from the array of objects into the writer
+    std::function<void(Writer&, const DataType*, std::size_t)> save;
+    /// scatter the member from the reader into the array of objects
+    std::function<void(h5::Reader&, DataType*, std::size_t)> load;
+  };
+
  private:
   /**
    * list of members in this dataset
@@ -232,6 +335,10 @@ class Data : public AbstractData<DataType> {
    * This is the core of schema evolution.
    */
   std::vector<std::tuple<bool,bool,std::unique_ptr<BaseData>>> members_;
+  /// the atomic members as columns with the same save/load flags as members_
+  std::vector<std::tuple<bool,bool,Column>> columns_;
+  /// are all of our members available as columns?
+  bool columnar_{true};
   /// pointer to the input file (if there is one)
   Reader* input_file_;
 };  // Data
@@ -267,7 +374,19 @@ class Data<AtomicType, std::enable_if_t<is_atomic_v<AtomicType>>>
    * @param[in] f h5::Reader to load from
    */
   void load(h5::Reader& f) final override {
-    f.load(this->path_, *(this->handle_));
+    read_buffer(f).read(*(this->handle_));
+  }
+
+  /**
+   * Move our Buffer to the input row
+   *
+   * @see h5::Reader::Buffer::seek for how the Buffer is moved
+   *
+   * @param[in] f h5::Reader to seek within
+   * @param[in] i_row index of row for the next load to read
+   */
+  void seek(h5::Reader& f, std::size_t i_row) final override {
+    read_buffer(f).seek(i_row);
   }
 
 #ifdef fire_USE_ROOT
@@ -289,7 +408,39 @@ class Data<AtomicType, std::enable_if_t<is_atomic_v<AtomicType>>>
    * @param[in] f io::Writer to save to
    */
   void save(Writer& f) final override {
-    f.save(this->path_, *(this->handle_));
+    write_buffer(f).save(*(this->handle_));
+  }
+
+  /**
+   * Load a span of entries, bypassing our handle
+   *
+   * @see h5::Reader::load for how the span is read
+   *
+   * @param[in] f h5::Reader to load from
+   * @param[out] vals pointer to first element to load into
+   * @param[in] n number of entries to load
+   * @param[in] stride number of bytes between successive elements
+   */
+  void load(h5::Reader& f, AtomicType* vals, std::size_t n,
+            std::size_t stride = sizeof(AtomicType)) {
+    if (n == 0) return;
+    read_buffer(f).read(vals, n, stride);
+  }
+
+  /**
+   * Save a span of entries, bypassing our handle
+   *
+   * @see io::Writer::save for how the span is written
+   *
+   * @param[in] f io::Writer to save to
+   * @param[in] vals pointer to first element to save
+   * @param[in] n number of entries to save
+   * @param[in] stride number of bytes between successive elements
+   */
+  void save(Writer& f, const AtomicType* vals, std::size_t n,
+            std::size_t stride = sizeof(AtomicType)) {
+    if (n == 0) return;
+    write_buffer(f).save(vals, n, stride);
   }
 
   /**
@@ -302,8 +453,73 @@ class Data<AtomicType, std::enable_if_t<is_atomic_v<AtomicType>>>
     // atomic types get translated into H5 DataSets
     // in save so we purposefully DO NOTHING here
   }
+
+ private:
+  /**
+   * Get the Buffer in the reader for our path
+   *
+   * The Buffer is only looked up by our path when we are
+   * given a reader different from the last one we read from.
+   *
+   * @param[in] f h5::Reader to load from
+   * @return reference to Buffer to read from
+   */
+  h5::Reader::Buffer<AtomicType>& read_buffer(h5::Reader& f) {
+    if (f.id() != reader_id_) {
+      read_buffer_ = &f.buffer<AtomicType>(this->path_);
+      reader_id_ = f.id();
+    }
+    return *read_buffer_;
+  }
+
+  /**
+   * Get the Buffer in the writer for our path
+   *
+   * The Buffer is only looked up by our path when we are
+   * given a writer different from the last one we saved to.
+   *
+   * @param[in] f io::Writer to save to
+   * @return reference to Buffer to write to
+   */
+  Writer::Buffer<AtomicType>& write_buffer(Writer& f) {
+    if (f.id() != writer_id_) {
+      write_buffer_ = &f.buffer<AtomicType>(this->path_);
+      writer_id_ = f.id();
+    }
+    return *write_buffer_;
+  }
+
+ private:
+  /// the buffer we last read from, only valid if reader_id_ matches the reader
+  h5::Reader::Buffer<AtomicType>* read_buffer_{nullptr};
+  /// ID of the reader read_buffer_ belongs to, zero is never a valid ID
+  std::size_t reader_id_{0};
+  /// the buffer we last wrote to, only valid if writer_id_ matches the writer
+  Writer::Buffer<AtomicType>* write_buffer_{nullptr};
+  /// ID of the writer write_buffer_ belongs to, zero is never a valid ID
+  std::size_t writer_id_{0};
 };  // Data<AtomicType>
 
+/**
+ * Check if the Data for a type can be saved and loaded column by column
+ *
+ * Only the general Data for user classes defines Data::columnar,
+ * so this is false for the other specializations.
+ *
+ * @tparam DataT type of io::Data to check
+ */
+template <typename DataT, typename = void>
+struct has_columns : std::false_type {};
+
+/**
+ * Specialization for io::Data defining Data::columnar
+ *
+ * @tparam DataT type of io::Data to check
+ */
+template <typename DataT>
+struct has_columns<DataT, std::void_t<decltype(std::declval<const DataT&>().columnar())>>
+    : std::true_type {};
+
 /**
  * Our wrapper around std::vector
  *
@@ -339,19 +555,41 @@ class Data<std::vector<ContentType>>
    * @note We assume that the loads are done sequentially.
    *
    * We read the next size and then read that many items from
-   * the content data set into the vector handle.
+   * the content data set into the vector handle. If the content
+   * is contiguous, the items are copied in bulk.
    *
    * @param[in] f h5::Reader to load from
    */
   void load(h5::Reader& f) final override {
     size_.load(f);
     this->handle_->resize(size_.get());
-    for (std::size_t i_vec{0}; i_vec < size_.get(); i_vec++) {
-      data_.load(f);
-      (*(this->handle_))[i_vec] = data_.get();
+    if constexpr (is_contiguous) {
+      data_.load(f, this->handle_->data(), size_.get());
+    } else if (columnar()) {
+      data_.load(f, this->handle_->data(), size_.get());
+    } else {
+      for (std::size_t i_vec{0}; i_vec < size_.get(); i_vec++) {
+        data_.load(f);
+        (*(this->handle_))[i_vec] = data_.get();
+      }
     }
   }
 
+  /**
+   * Seek to a vector in the input file
+   *
+   * The size data set has one row per vector, while the content
+   * of the vector starts at the sum of the sizes before it,
+   * which the reader caches (see h5::Reader::offset).
+   *
+   * @param[in] f h5::Reader to seek within
+   * @param[in] i_row index of vector for the next load to read
+   */
+  void seek(h5::Reader& f, std::size_t i_row) final override {
+    size_.seek(f, i_row);
+    data_.seek(f, f.offset(this->path_ + "/" + constants::SIZE_NAME, i_row));
+  }
+
 #ifdef fire_USE_ROOT
   /**
    * Loading this dataset from a ROOT file involves giving
@@ -368,15 +606,22 @@ class Data<std::vector<ContentType>>
    * @note We assume that the saves are done sequentially.
    *
    * We write the size and the content onto the end of their data sets.
+   * If the content is contiguous, the items are copied in bulk.
    *
    * @param[in] f io::Writer to save to
    */
   void save(Writer& f) final override {
     size_.update(this->handle_->size());
     size_.save(f);
-    for (std::size_t i_vec{0}; i_vec < this->handle_->size(); i_vec++) {
-      data_.update(this->handle_->at(i_vec));
-      data_.save(f);
+    if constexpr (is_contiguous) {
+      data_.save(f, this->handle_->data(), this->handle_->size());
+    } else if (columnar()) {
+      data_.save(f, this->handle_->data(), this->handle_->size());
+    } else {
+      for (std::size_t i_vec{0}; i_vec < this->handle_->size(); i_vec++) {
+        data_.update(this->handle_->at(i_vec));
+        data_.save(f);
+      }
     }
   }
 
@@ -387,6 +632,29 @@ class Data<std::vector<ContentType>>
   }
 
  private:
+  /**
+   * Can the content be saved and loaded as a single span?
+   *
+   * This is true for atomic types except for bools since
+   * std::vector<bool> does not store its elements contiguously.
+   */
+  static constexpr bool is_contiguous =
+      is_atomic_v<ContentType> and not std::is_same_v<ContentType,bool>;
+  /**
+   * Can the content be saved and loaded one member at a time?
+   *
+   * This is only possible for user classes whose members are
+   * all atomic, see Data::columnar.
+   *
+   * @return true if the content can be gathered/scattered by column
+   */
+  bool columnar() const {
+    if constexpr (has_columns<Data<ContentType>>::value) {
+      return data_.columnar();
+    } else {
+      return false;
+    }
+  }
   /// the data set of sizes of the vectors
   Data<std::size_t> size_;
   /// the data set holding the content of all the vectors
@@ -443,6 +711,22 @@ class Data<std::map<KeyType,ValType>>
     }
   }
 
+  /**
+   * Seek to a map in the input file
+   *
+   * Like io::Data<std::vector<ContentType>>::seek, the keys and
+   * vals start at the sum of the sizes before the map.
+   *
+   * @param[in] f h5::Reader to seek within
+   * @param[in] i_row index of map for the next load to read
+   */
+  void seek(h5::Reader& f, std::size_t i_row) final override {
+    size_.seek(f, i_row);
+    std::size_t offset{f.offset(this->path_ + "/" + constants::SIZE_NAME, i_row)};
+    keys_.seek(f, offset);
+    vals_.seek(f, offset);
+  }
+
 #ifdef fire_USE_ROOT
   /**
    * Loading this dataset from a ROOT file involves giving
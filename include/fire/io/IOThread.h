@@ -0,0 +1,122 @@
+#ifndef FIRE_IO_IOTHREAD_H
+#define FIRE_IO_IOTHREAD_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fire::io {
+
+/**
+ * Mutex serializing calls into the HDF5 library
+ *
+ * The HDF5 library is not built thread-safe by default, so any
+ * calls into it (directly or through HighFive) that could happen
+ * while an IOThread is working must be made while holding this mutex.
+ * It is recursive so that helper functions which lock it can be
+ * called from other functions which already hold it.
+ *
+ * @return reference to the single process-wide HDF5 mutex
+ */
+std::recursive_mutex& hdf5_mutex();
+
+/**
+ * Background thread(s) executing disk operations
+ *
+ * Jobs are started in the same order that they are submitted
+ * and there is a maximum number of jobs that are allowed to be
+ * waiting or running at once. Submitting a job while this maximum
+ * is reached blocks until the threads have caught up, bounding the
+ * memory held by the jobs in flight.
+ *
+ * By default, there is a single thread so the jobs are also
+ * executed one at a time in order. With more than one thread,
+ * jobs run concurrently and so they must be independent of
+ * each other (e.g. compressing separate chunks).
+ *
+ * If a job throws an exception, the jobs queued behind it are dropped
+ * and the exception is re-thrown on the next call to submit or wait
+ * so that it is seen by the thread that owns this IOThread.
+ */
+class IOThread {
+ public:
+  /**
+   * Start the background thread(s)
+   *
+   * @param[in] max_in_flight maximum number of jobs waiting or running
+   * @param[in] num_threads number of threads to run jobs on
+   */
+  explicit IOThread(std::size_t max_in_flight, std::size_t num_threads = 1);
+
+  /**
+   * Finish any remaining jobs and then join the background thread(s)
+   *
+   * Any exception thrown by a job at this point is dropped since
+   * we are unable to throw from a destructor.
+   */
+  ~IOThread();
+
+  /**
+   * Put a new job at the end of the queue
+   *
+   * @throws any exception thrown by a previous job
+   * @param[in] job function to execute on the background thread
+   */
+  void submit(std::function<void()> job);
+
+  /**
+   * Block until all submitted jobs have been executed
+   *
+   * @throws any exception thrown by a previous job
+   */
+  void wait();
+
+  /// never copy a thread
+  IOThread(const IOThread&) = delete;
+  /// never copy a thread
+  void operator=(const IOThread&) = delete;
+
+ private:
+  /**
+   * Loop executed by each background thread
+   *
+   * We wait for jobs to arrive and execute them in order until
+   * we are told to stop and the queue is empty.
+   */
+  void loop();
+
+  /**
+   * Re-throw the exception from a job if there was one
+   *
+   * @note must be called while holding mutex_
+   */
+  void rethrow();
+
+ private:
+  /// maximum number of jobs waiting or running
+  std::size_t max_in_flight_;
+  /// jobs waiting to be run
+  std::deque<std::function<void()>> queue_;
+  /// number of jobs currently running
+  std::size_t running_{0};
+  /// have we been told to stop?
+  bool stop_{false};
+  /// the first exception thrown by a job
+  std::exception_ptr error_;
+  /// mutex guarding the queue and flags above
+  std::mutex mutex_;
+  /// signal the background threads that there is a new job or we are stopping
+  std::condition_variable job_ready_;
+  /// signal the owning thread that a job has finished
+  std::condition_variable job_done_;
+  /// the background threads themselves, started last in construction
+  std::vector<std::thread> threads_;
+};
+
+}  // namespace fire::io
+
+#endif  // FIRE_IO_IOTHREAD_H
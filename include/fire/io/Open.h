@@ -29,9 +29,11 @@ namespace fire::io {
  * - `h5` or `hdf5` : use fire::io::h5::Reader
  *
  * @param[in] fp file path to file to open
+ * @param[in] ps parameters passed on to the reader, e.g. `prefetch`
  * @return pointer to io::Reader that has opened file
  */
-std::unique_ptr<io::Reader> open(const std::string& fp);
+std::unique_ptr<io::Reader> open(const std::string& fp,
+    const config::Parameters& ps = config::Parameters());
 
 }
 
@@ -174,6 +174,16 @@ class Data<ParameterStorage> : public AbstractData<ParameterStorage> {
    */
   void load(h5::Reader& r) final override;
 
+  /**
+   * seek all of the parameters to the input row
+   *
+   * The parameters are discovered first if they have not been yet.
+   *
+   * @param[in] r h5::Reader to seek within
+   * @param[in] i_row index of row for the next load to read
+   */
+  void seek(h5::Reader& r, std::size_t i_row) final override;
+
 #ifdef fire_USE_ROOT
   /**
    * Only here to conform to abstract base class
@@ -229,11 +239,28 @@ class Data<ParameterStorage> : public AbstractData<ParameterStorage> {
         std::get_if<ParameterType>(&(this->handle_->parameters_[name])));
   }
 
+  /**
+   * Discover the parameters on disk on the first load or seek
+   *
+   * We use our path member to list the objects in the group
+   * (h5::Reader::list). Then for each member of this list,
+   * we get its type (h5::Reader::getDataSetType) from its path
+   * and create a new object in the variant map of the
+   * ParameterStorage pointed to by our handle. Then we use
+   * the attach method to create a new dataset to track the
+   * parameter.
+   *
+   * @param[in] r h5::Reader to discover parameters in
+   */
+  void discover(h5::Reader& r);
+
  private:
   /// the dynamic parameter listing (parallel to parameters_ member variable)
   std::unordered_map<std::string, std::unique_ptr<BaseData>> parameters_;
   /// the input file we are reading from
   Reader* input_file_;
+  /// have we discovered the parameters on disk yet?
+  bool discovered_{false};
 };
 
 }
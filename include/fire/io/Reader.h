@@ -4,6 +4,7 @@
 #include <iostream>
 #include <vector>
 
+#include "fire/config/Parameters.h"
 #include "fire/factory/Factory.h"
 #include "fire/io/AbstractData.h"
 
@@ -25,6 +26,11 @@ namespace fire::io {
  * Besides deriving this class, additional io::Data::load methods need
  * to be defined so that the Reader and successfully interact with the 
  * in-memory data objects.
+ *
+ * Derived readers are constructed with the file name and a set of
+ * config::Parameters configuring how the file is read. Readers should
+ * use config::Parameters::get with a default so that they can be
+ * constructed with an empty set of parameters.
  */
 class Reader {
  public:
@@ -58,6 +64,36 @@ class Reader {
    */
   virtual void load_into(BaseData& d) = 0;
 
+  /**
+   * Move the passed data object so that its next load is the input entry
+   *
+   * Readers that cannot seek load the entries before the input one,
+   * so the data object must not have been loaded from yet. Readers that
+   * can seek should override this to call the data's seek function.
+   *
+   * @param[in] d data object to move, not loaded from yet
+   * @param[in] i_entry entry index for the next load to read
+   */
+  virtual void seek_into(BaseData& d, std::size_t i_entry) {
+    for (std::size_t i{0}; i < i_entry; i++) load_into(d);
+  }
+
+  /**
+   * Skip the entries before the input one without keeping them in memory
+   *
+   * The data object's next load would read the entry n before the
+   * input one. Readers that cannot seek load the skipped entries,
+   * while readers that can seek should override this to move the
+   * data straight to the input entry.
+   *
+   * @param[in] d data object to move
+   * @param[in] i_entry entry index for the next load to read
+   * @param[in] n number of entries to skip
+   */
+  virtual void skip_into(BaseData& d, std::size_t /*i_entry*/, std::size_t n) {
+    for (std::size_t i{0}; i < n; i++) load_into(d);
+  }
+
   /**
    * Return the name of the file
    * @return name of file
@@ -88,6 +124,28 @@ class Reader {
    */
   virtual std::pair<std::string,int> type(const std::string& path) = 0;
 
+  /**
+   * Get the total time spent waiting on data read in the background
+   *
+   * Readers that do not read ahead never wait on a background read.
+   *
+   * @return seconds spent waiting for prefetched data
+   */
+  virtual double prefetchStallTime() const {
+    return 0.;
+  }
+
+  /**
+   * Get the most memory held by the in-memory buffers at once
+   *
+   * Readers that do not buffer their data hold no memory.
+   *
+   * @return peak number of bytes held in buffers
+   */
+  virtual std::size_t peakBufferBytes() const {
+    return 0;
+  }
+
   /**
    * Event::get needs to know if the reader implements a copy that advances
    * the entry index of the data sets being read
@@ -98,6 +156,16 @@ class Reader {
     return false;
   }
 
+  /**
+   * Several events are read at once if the reader is able to seek
+   * each data object to any entry without loading the ones before it
+   *
+   * @return true if the reader overrides seek_into and skip_into to seek
+   */
+  virtual bool canSeek() const {
+    return false;
+  }
+
   /**
    * Copy the input object into the output file
    * @param[in] i_entry the entry index that is being copied from this reader to output
@@ -109,10 +177,35 @@ class Reader {
       " with Event::get so it is not being written to the output file." << std::endl;
   }
 
+  /**
+   * Pad the input object in the output file with cleared entries
+   *
+   * This is used when an object that is being copied first appears
+   * after entries without it have already been written to the output
+   * file. Readers that do not copy have nothing to pad.
+   *
+   * @param[in] path the full object path that should be padded
+   * @param[in] n number of entries to pad
+   * @param[out] output the writer we should write the padding to
+   */
+  virtual void pad(const std::string& /*path*/, std::size_t /*n*/, Writer& /*output*/) {}
+
+  /**
+   * Finish any copies into the output file that are waiting
+   *
+   * Readers may gather the entries passed to copy in order to copy
+   * many at once, so this is called before closing the reader.
+   * Readers that gather entries should tell the Writer with
+   * Writer::copying so it can have them finish when it is flushed.
+   * Readers that copy immediately have nothing to finish.
+   */
+  virtual void finishCopies() {}
+
   /**
    * Type of factory used to create readers
    */
-  using Factory = ::fire::factory::Factory<Reader, std::unique_ptr<Reader>, const std::string&>;
+  using Factory = ::fire::factory::Factory<Reader, std::unique_ptr<Reader>,
+                                          const std::string&, const config::Parameters&>;
 };
 
 }
@@ -0,0 +1,168 @@
+#ifndef FIRE_IO_TRACE_H
+#define FIRE_IO_TRACE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fire::io {
+
+/**
+ * Timeline of the spans of time spent in the parts of processing
+ *
+ * The tracer is process-wide and disabled unless it is opened with
+ * a file to write the timeline to. While it is open, each Span records
+ * when it started and how long it took on which thread. The spans are
+ * written to the file in the Chrome trace-event JSON format, which can
+ * be opened by chrome://tracing or ui.perfetto.dev, in batches of
+ * FLUSH_RECORDS as they finish so that long runs do not keep all of
+ * them in memory. The file is completed when the tracer is closed.
+ *
+ * Spans within an event (e.g. the process method of a processor) are
+ * sampled so that only every Nth event is recorded, keeping the overhead
+ * small on long runs. Spans of the disk operations (e.g. loading a chunk)
+ * are not tied to an event and are always recorded.
+ *
+ * While disabled, a Span only checks an atomic flag, so the spans can
+ * be left in the code that is not traced.
+ */
+class Trace {
+ public:
+  /// number of finished spans to gather before writing them to the file
+  static const std::size_t FLUSH_RECORDS{4096};
+
+  /**
+   * Start recording spans
+   *
+   * The file of a previous opening of the tracer that was not closed
+   * is left incomplete and the spans it had not written are dropped.
+   *
+   * @throws Exception if the file cannot be opened
+   *
+   * @param[in] file name of the file to write the timeline to
+   * @param[in] every record the spans of every this many events
+   */
+  static void open(const std::string& file, std::size_t every);
+
+  /**
+   * Stop recording spans and finish writing them to the file
+   *
+   * Nothing is done if the tracer is not open.
+   *
+   * @throws Exception if the file cannot be written
+   */
+  static void close();
+
+  /**
+   * Is the tracer recording spans?
+   * @return true if the tracer is open
+   */
+  static bool enabled() { return enabled_.load(std::memory_order_relaxed); }
+
+  /**
+   * Should the spans of the input event be recorded?
+   * @param[in] n_event index of the event in processing
+   * @return true if the tracer is open and the event is sampled
+   */
+  static bool sampled(std::size_t n_event) {
+    return enabled() and n_event % every_ == 0;
+  }
+
+  /**
+   * Record the span of time from construction to destruction
+   */
+  class Span {
+   public:
+    /**
+     * Start the span
+     *
+     * The name and detail are only copied if the span is recorded.
+     *
+     * @param[in] name name of the span shown on the timeline
+     * @param[in] category category of the span, must be a string literal
+     * @param[in] record false if the span belongs to an event that is not sampled
+     * @param[in] detail extra information shown with the span, may be empty
+     */
+    Span(const std::string& name, const char* category, bool record = true,
+         const std::string& detail = {});
+
+    /// record the span if we are recording
+    ~Span();
+
+    /// spans are not copied
+    Span(const Span&) = delete;
+    /// spans are not copied
+    Span& operator=(const Span&) = delete;
+
+   private:
+    /// are we recording this span?
+    bool record_;
+    /// name of the span
+    std::string name_;
+    /// category of the span
+    const char* category_;
+    /// extra information shown with the span
+    std::string detail_;
+    /// when the span started
+    std::chrono::steady_clock::time_point start_;
+  };
+
+ private:
+  /**
+   * Record a finished span
+   * @param[in] name name of the span
+   * @param[in] category category of the span
+   * @param[in] detail extra information shown with the span
+   * @param[in] start when the span started
+   * @param[in] end when the span ended
+   */
+  static void record(std::string&& name, const char* category, std::string&& detail,
+                     std::chrono::steady_clock::time_point start,
+                     std::chrono::steady_clock::time_point end);
+
+  /**
+   * Write the finished spans we have gathered to the file
+   *
+   * The mutex must be held while calling this.
+   */
+  static void flush();
+
+  /// a finished span waiting to be written out
+  struct Record {
+    /// name of the span
+    std::string name;
+    /// category of the span
+    const char* category;
+    /// extra information shown with the span
+    std::string detail;
+    /// start relative to opening the tracer [us]
+    double start;
+    /// length of span [us]
+    double duration;
+    /// index of the thread the span was on
+    std::size_t thread;
+  };
+
+  /// are we recording spans?
+  inline static std::atomic<bool> enabled_{false};
+  /// record every this many events
+  inline static std::size_t every_{1};
+  /// name of file we are writing the timeline to
+  inline static std::string file_;
+  /// file we are writing the timeline to
+  inline static std::ofstream out_;
+  /// when the tracer was opened
+  inline static std::chrono::steady_clock::time_point opened_;
+  /// guards the finished spans and the file
+  inline static std::mutex mutex_;
+  /// the finished spans that have not been written yet
+  inline static std::vector<Record> records_;
+};
+
+}  // namespace fire::io
+
+#endif  // FIRE_IO_TRACE_H
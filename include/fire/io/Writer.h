@@ -1,20 +1,102 @@
 #ifndef FIRE_IO_H5_WRITER_H
 #define FIRE_IO_H5_WRITER_H
 
+#include <limits>
+#include <optional>
+
 // using HighFive
 #include <highfive/H5File.hpp>
 
 #include "fire/config/Parameters.h"
 #include "fire/io/Atomic.h"
 #include "fire/io/Constants.h"
+#include "fire/io/IOThread.h"
+#include "fire/io/Trace.h"
+#include "fire/Timing.h"
 
 namespace fire::io {
 
+template <typename DataType, typename Enable> class Data;
+class Reader;
+
 /**
  * Write the fire DataSets into a deterministic structure
  * in the output HDF5 data file.
  *
  * @see h5::Reader for where our files are read
+ *
+ * ## Asynchronous Writing
+ * If the `async_write` parameter is set, full buffers are not written
+ * to disk by the thread calling save. Instead, a full buffer is swapped
+ * for an empty one and handed to an IOThread which does the compression
+ * and writing in the background. At most `max_in_flight` full buffers
+ * are allowed to be waiting for the IOThread at once, bounding the
+ * extra memory used. Writer::flush and Writer::~Writer wait for all
+ * of the buffers to be written before returning.
+ *
+ * ## Compression
+ * The `compression` parameter chooses the filter used to compress
+ * the datasets we create.
+ * - `deflate` : the HDF5 built-in Deflate (gzip) filter at `compression_level`
+ * - `zstd` : the Zstandard filter plugin (32015) at `compression_level`
+ * - `lz4` : the LZ4 filter plugin (32004)
+ * - `blosc` : the Blosc filter plugin (32001) using LZ4 at `compression_level`
+ * - `none` : no compression
+ *
+ * If `shuffle` is true, the data is shuffled before being compressed.
+ * This is the HDF5 Shuffle filter except for Blosc which does a bitshuffle
+ * internally. The plugins need to be installed for HDF5 to find them
+ * (usually via the HDF5_PLUGIN_PATH environment variable) when writing
+ * and when reading. The filter is recorded in the file by HDF5 so no
+ * configuration is needed by readers.
+ *
+ * If `compression_threads` is greater than zero (only allowed with
+ * `deflate`), full chunks are shuffled and compressed by us on a pool
+ * of that many threads and then written directly into the file,
+ * bypassing the HDF5 filter pipeline (see ChunkCompressor).
+ * The chunks are identical to what the HDF5 filters would produce,
+ * so the file is read in the same way.
+ *
+ * ## Chunk Sizes
+ * By default, every dataset is chunked (and buffered in memory) by
+ * `rows_per_chunk` rows no matter how large each row is. If `chunk_bytes`
+ * is greater than zero, the number of rows in each chunk is chosen per
+ * dataset so that a chunk holds about `chunk_bytes` bytes given the size
+ * of the type stored in the dataset. Strings are variable length and
+ * so their datasets stay at `rows_per_chunk` rows.
+ *
+ * If `chunk_adapt_events` is greater than zero, the datasets are not
+ * created until that many events have been saved (see Writer::nextEvent).
+ * The rows saved so far are held in memory and, when the datasets are
+ * created, we use the observed number of rows per event to avoid
+ * making a chunk longer than the number of rows we expect to end up
+ * in the dataset by the event limit. This keeps the datasets holding
+ * rarely-filled data from each allocating a mostly-empty chunk.
+ *
+ * ## Memory Budget
+ * If `memory_budget` is greater than zero, the buffers are kept from
+ * holding more than that many megabytes all together. At the end of each
+ * event (see Writer::nextEvent), if the buffers are over the budget, the
+ * largest buffers are written to disk early and their memory released
+ * until we are within the budget. A buffer that has been written early
+ * no longer reserves a full chunk of memory up front. Writing partial
+ * chunks is slower, so the budget should only be set when needed.
+ * The peak memory held by the buffers is recorded either way
+ * (see Writer::peakBufferBytes).
+ *
+ * ## Buffer Handles
+ * The io::Data wrapping atomic types are allowed to retrieve and keep
+ * a reference to their typed Buffer so that they do not need to look
+ * up the Buffer by its path on every save. Since a Writer may be
+ * destroyed and another constructed at the same address, each Writer
+ * has a unique ID which io::Data uses to check that its reference is
+ * still valid.
+ *
+ * ## Copies Waiting in Readers
+ * Readers may gather the entries they are asked to copy into us so that
+ * they can copy many at once (see Reader::finishCopies). Those readers
+ * tell us they are copying and we have them finish when we are flushed,
+ * so the copies are not lost if we are closed before the reader.
  */
 class Writer {
  public:
@@ -30,16 +112,49 @@ class Writer {
 
   /**
    * Close up our file, making sure to flush contents to disk
+   *
+   * We also stop the IOThread (if there is one) and close the file
+   * while holding the hdf5_mutex so that any other threads
+   * accessing HDF5 are not disrupted.
    */
   ~Writer();
 
   /**
    * Flush the data to disk
    *
-   * We flush all buffers and then flush the file.
+   * We have the readers copying into us finish their copies, flush
+   * all buffers, wait for the IOThread to finish writing them
+   * (if we are writing asynchronously), and then flush the file.
    */
   void flush();
 
+  /**
+   * Remember a reader that has copies into us waiting
+   *
+   * @param[in] reader reader gathering entries to copy into us
+   */
+  void copying(Reader& reader);
+
+  /**
+   * Forget a reader that has no more copies into us waiting
+   *
+   * @param[in] reader reader that finished its copies into us
+   */
+  void doneCopying(Reader& reader);
+
+  /**
+   * Time the writing of our buffers to disk
+   *
+   * Each write of a buffer's full chunks while saving, and of what is
+   * left of it when flushing, is timed with a "Writer::flush" timer.
+   * When compressing on a pool of threads, the compression of each chunk
+   * is timed with a "Writer::compress" timer as well. This must be done
+   * before anything is saved.
+   *
+   * @param[in] timing timers to add ours to and record into
+   */
+  void time(Timing& timing);
+
   /**
    * Get the name of this file
    */
@@ -66,6 +181,31 @@ class Writer {
    */
   inline std::size_t entries() const { return entries_; }
 
+  /**
+   * Mark the end of an event
+   *
+   * We count the events so that, if we are adapting the chunk sizes,
+   * we create the pending datasets once `chunk_adapt_events` events
+   * have been saved. Then we keep the buffers within the memory budget.
+   */
+  void nextEvent();
+
+  /**
+   * Get the number of events that have been saved
+   * @return number of calls to nextEvent so far
+   */
+  inline std::size_t events() const { return events_; }
+
+  /**
+   * Get the most memory held by our buffers at once
+   *
+   * The memory is counted at the end of each event as the capacity
+   * of each buffer times the size of its type.
+   *
+   * @return peak number of bytes held by the buffers
+   */
+  inline std::size_t peakBufferBytes() const { return peak_bytes_; }
+
   /**
    * Save an atomic type into the dataset at the passed path
    *
@@ -86,29 +226,107 @@ class Writer {
     static_assert(
         is_atomic_v<AtomicType>,
         "Type unsupported by HighFive as Atomic made its way to Writer::save");
-    if (buffers_.find(path) == buffers_.end()) {
-      // first save attempt, need to create the data set to be saved
-      // - we pass the newly created dataset to the buffer to hold onto
-      //    for flushing purposes
-      // - the length of the buffer is the same size as the chunks in
-      //    HDF5, this is done on purpose
-      // - if the type is a bool, we define the HighFive type to be
-      //    our custom enum which mimics the type used by h5py
-      HighFive::DataType t;
-      if constexpr (std::is_same_v<AtomicType,bool>) {
-        t = create_enum_bool();
-      } else {
-        t = HighFive::AtomicType<AtomicType>();
-      }
-      auto ds = file_->createDataSet(path, space_, t, create_props_);
-      ds.createAttribute(constants::TYPE_ATTR_NAME, boost::core::demangle(typeid(AtomicType).name()));
-      ds.createAttribute(constants::VERS_ATTR_NAME, 0);
-      buffers_.emplace(path, 
-          std::make_unique<Buffer<AtomicType>>(rows_per_chunk_, ds));
-    }
-    dynamic_cast<Buffer<AtomicType>&>(*buffers_.at(path)).save(val);
+    buffer<AtomicType>(path).save(val);
   }
 
+  /**
+   * Save a span of atomic types into the dataset at the passed path
+   *
+   * This is the bulk version of save, the span is appended to the
+   * Buffer in one pass rather than one lookup of the Buffer per
+   * element. Saving zero elements does nothing and, in particular,
+   * does not create the DataSet.
+   *
+   * The elements of the span are separated by stride bytes so that
+   * we can gather the same member from an array of objects. The default
+   * stride is for a contiguous array of elements which is copied with
+   * a single insertion.
+   *
+   * @note std::vector<bool> does not hold its elements in an array
+   * so it cannot be saved through this method.
+   *
+   * @throws std::bad_cast if mismatched type is passed to buffer
+   * @throws HighFive::DataSetException if unable to create data set
+   *
+   * @param[in] path full in-file path to the dataset
+   * @param[in] vals pointer to the first element to save
+   * @param[in] n number of elements to save
+   * @param[in] stride number of bytes between successive elements
+   */
+  template <typename AtomicType>
+  void save(const std::string& path, const AtomicType* vals, std::size_t n,
+            std::size_t stride = sizeof(AtomicType)) {
+    static_assert(
+        is_atomic_v<AtomicType>,
+        "Type unsupported by HighFive as Atomic made its way to Writer::save");
+    if (n == 0) return;
+    buffer<AtomicType>(path).save(vals, n, stride);
+  }
+
+  /**
+   * Copy rows of a dataset in another file onto the end of the dataset at the passed path
+   *
+   * This is how event objects that are kept but never accessed are
+   * copied from an input file without going through io::Data.
+   * If the input dataset has the same chunk length, filters, and type
+   * as ours, whole chunks are copied without decompressing them
+   * (see Buffer::copy). Otherwise, the rows are read in batches
+   * and saved like any other span of values. Copying zero rows
+   * does nothing.
+   *
+   * @throws std::bad_cast if mismatched type is passed to buffer
+   * @throws HighFive::DataSetException if unable to create data set
+   *
+   * @param[in] path full in-file path to the dataset to copy into
+   * @param[in] src dataset to copy from
+   * @param[in] i_src index of first row in src to copy
+   * @param[in] n number of rows to copy
+   */
+  template <typename AtomicType>
+  void copy(const std::string& path, const HighFive::DataSet& src, 
+            std::size_t i_src, std::size_t n) {
+    static_assert(
+        is_atomic_v<AtomicType>,
+        "Type unsupported by HighFive as Atomic made its way to Writer::copy");
+    if (n == 0) return;
+    buffer<AtomicType>(path).copy(src, i_src, n);
+  }
+
+  /**
+   * Append cleared rows to the dataset at the passed path
+   *
+   * This is used to keep the entries of an event object aligned with
+   * the other objects when it is missing from some of the entries
+   * (see padObject). Numbers are cleared to their minimum like io::Data
+   * does and other atomic types to their default value.
+   *
+   * @throws std::bad_cast if mismatched type is passed to buffer
+   *
+   * @param[in] path full in-file path to the dataset
+   * @param[in] n number of rows to append
+   */
+  template <typename AtomicType>
+  void pad(const std::string& path, std::size_t n) {
+    static_assert(
+        is_atomic_v<AtomicType>,
+        "Type unsupported by HighFive as Atomic made its way to Writer::pad");
+    if (n == 0) return;
+    buffer<AtomicType>(path).pad(n);
+  }
+
+  /**
+   * Append cleared entries to an event object already being written
+   *
+   * The datasets of the object are found among our buffers, so the object
+   * must have been saved or copied before. The size datasets of containers
+   * are padded with zeros and their contents are left alone since the
+   * padded entries are empty. All other datasets are padded like Writer::pad.
+   *
+   * @param[in] path full in-file path to the event object
+   * @param[in] n number of entries to append
+   */
+  void padObject(const std::string& path, std::size_t n);
+
   /**
    * Stream this writer
    *
@@ -128,6 +346,72 @@ class Writer {
   void operator=(const Writer&) = delete;
 
  private:
+  /**
+   * Compress full chunks on a pool of threads and write them directly
+   *
+   * The compression done here mimics the HDF5 Shuffle (if enabled) and
+   * Deflate filters exactly, so the chunks written with H5Dwrite_chunk
+   * are read back through the standard filter pipeline by any reader.
+   * Each chunk is compressed without holding the hdf5_mutex and then
+   * written while holding it, so many chunks can be compressed at once.
+   */
+  class ChunkCompressor {
+   public:
+    /**
+     * Start the pool of threads
+     *
+     * @param[in] num_threads number of threads to compress with
+     * @param[in] level Deflate compression level
+     * @param[in] shuffle apply Shuffle before Deflate
+     */
+    ChunkCompressor(std::size_t num_threads, unsigned int level, bool shuffle);
+
+    /**
+     * Compress and write a full chunk in the background
+     *
+     * The dataset must already be extended to include the chunk.
+     *
+     * @param[in] set ID of dataset to write to
+     * @param[in] i_file index of first element of chunk, a multiple of the chunk length
+     * @param[in] chunk pointer to the first byte of the chunk in memory
+     * @param[in] chunk_len number of elements in the chunk
+     * @param[in] elem_size number of bytes in each element
+     * @param[in] keep_alive owner of the chunk memory, held until written
+     */
+    void submit(hid_t set, std::size_t i_file, const char* chunk, std::size_t chunk_len,
+                std::size_t elem_size, std::shared_ptr<const void> keep_alive);
+
+    /**
+     * Wait for all of the submitted chunks to be written
+     *
+     * @throws any exception thrown while compressing or writing a chunk
+     */
+    void wait();
+
+    /**
+     * Time the compression of each chunk
+     *
+     * @param[in] timing timers to record into
+     * @param[in] timer id of the timer to record into
+     */
+    void time(Timing& timing, std::size_t timer) {
+      timing_ = &timing;
+      timer_ = timer;
+    }
+
+   private:
+    /// timers to record into, nullptr if not timing
+    Timing* timing_{nullptr};
+    /// id of the timer of compressing a chunk
+    std::size_t timer_{0};
+    /// Deflate compression level
+    unsigned int level_;
+    /// apply Shuffle before Deflate
+    bool shuffle_;
+    /// the threads doing the compressing, last so it is destroyed first
+    IOThread pool_;
+  };
+
   /**
    * Type-less handle to buffers
    *
@@ -137,20 +421,33 @@ class Writer {
    */
   class BufferHandle {
    protected:
-    /// the maximum size of the buffer
+    /// the writer creating our dataset
+    Writer& writer_;
+    /// full in-file path to the dataset
+    std::string path_;
+    /// the maximum size of the buffer, zero until the dataset is created
     std::size_t max_len_;
-    /// the H5 dataset we are writing to
-    HighFive::DataSet set_;
+    /// the H5 dataset we are writing to, empty until it is created
+    std::optional<HighFive::DataSet> set_;
+    /// the thread to hand full buffers to, nullptr if writing synchronously
+    IOThread* io_thread_;
+    /// the pool to compress full chunks with, nullptr if using the HDF5 filters
+    ChunkCompressor* compressor_;
 
    public:
     /**
-     * Define the maximum size of the buffer and the dataset we are writing to
+     * Define the path to the dataset we are writing to
      *
-     * @param[in] max size of buffer
-     * @param[in] s dataset to write to
+     * The dataset itself is created later by BufferHandle::create.
+     *
+     * @param[in] w writer to create the dataset with
+     * @param[in] path full in-file path to the dataset
+     * @param[in] io thread to write with, nullptr if we should write synchronously
+     * @param[in] compressor pool to compress chunks with, nullptr to use HDF5 filters
      */
-    explicit BufferHandle(std::size_t max, HighFive::DataSet s)
-        : max_len_{max}, set_{s} {}
+    explicit BufferHandle(Writer& w, const std::string& path, IOThread* io,
+                          ChunkCompressor* compressor)
+        : writer_{w}, path_{path}, max_len_{0}, io_thread_{io}, compressor_{compressor} {}
     /**
      * virtual destructor so derived Buffer can be destructed properly
      */
@@ -164,6 +461,50 @@ class Writer {
      * stored within them.
      */
     virtual void flush() = 0;
+    /**
+     * Create the dataset with the input chunk length
+     *
+     * The chunk length is also the maximum length of the buffer
+     * and any full chunks already in the buffer are written out.
+     *
+     * @param[in] chunk_len number of rows in each chunk of the dataset
+     */
+    virtual void create(std::size_t chunk_len) = 0;
+    /**
+     * Number of bytes in each row of the dataset
+     * @return size of type on disk, zero for variable-length types
+     */
+    virtual std::size_t rowSize() const = 0;
+    /**
+     * Number of rows saved to this buffer
+     * @return number of rows written or waiting to be written
+     */
+    virtual std::size_t rows() const = 0;
+    /**
+     * Has the dataset been created yet?
+     * @return true if the dataset exists in the file
+     */
+    bool created() const { return set_.has_value(); }
+    /**
+     * Memory held by this buffer
+     *
+     * Strings are counted by the size of std::string itself.
+     *
+     * @return bytes allocated for the buffer
+     */
+    virtual std::size_t bytes() const = 0;
+    /**
+     * Write out our entire buffer and release its memory
+     *
+     * The buffer no longer reserves a full chunk after this.
+     * The dataset must have been created.
+     */
+    virtual void release() = 0;
+    /**
+     * Append cleared rows to the buffer
+     * @param[in] n number of rows to append
+     */
+    virtual void pad(std::size_t n) = 0;
   };
 
   /**
@@ -173,14 +514,32 @@ class Writer {
    */
   template <typename AtomicType>
   class Buffer : public BufferHandle {
+    /// the type on disk, handling the bool specialization
+    using DiskType = std::conditional_t<std::is_same_v<AtomicType,bool>,Bool,AtomicType>;
     /// the actual buffer of data in-memory
     std::vector<AtomicType> buffer_;
     /// the index of the file we will write to on the next flush
     std::size_t i_file_;
+    /// have we been released? if so, we don't reserve memory up front
+    bool released_{false};
 
    public:
     /**
-     * Define the buffer size and the set we will write to
+     * Define the set we will write to
+     *
+     * @param[in] w writer to create the dataset with
+     * @param[in] path full in-file path to the dataset
+     * @param[in] io thread to write with, nullptr if we should write synchronously
+     * @param[in] compressor pool to compress chunks with, nullptr to use HDF5 filters
+     */
+    explicit Buffer(Writer& w, const std::string& path, IOThread* io,
+                    ChunkCompressor* compressor)
+        : BufferHandle(w, path, io, compressor), buffer_{}, i_file_{0} {}
+    /// destruct the in-memory buffer
+    virtual ~Buffer() = default;
+
+    /**
+     * Create the dataset and set the buffer size
      *
      * We also use std::vector::reserve to let the memory
      * handler know the size of our buffer. This can help
@@ -188,43 +547,246 @@ class Writer {
      * using std::vector::push_back to insert elements into
      * the vector.
      *
-     * @param[in] max buffer size
-     * @param[in] s dataset to write to
+     * @param[in] chunk_len number of rows in each chunk of the dataset
      */
-    explicit Buffer(std::size_t max, HighFive::DataSet s)
-        : BufferHandle(max, s), buffer_{}, i_file_{0} {
+    virtual void create(std::size_t chunk_len) final override {
+      Trace::Span span{"Writer::create", "io", true, this->path_};
+      this->set_ = this->writer_.template create_dataset<AtomicType>(this->path_, chunk_len);
+      this->max_len_ = chunk_len;
       buffer_.reserve(this->max_len_);
+      if (buffer_.size() >= this->max_len_) flush_chunks();
+    }
+
+    /// size of type on disk, strings are variable length
+    virtual std::size_t rowSize() const final override {
+      if constexpr (std::is_same_v<AtomicType, std::string>) return 0;
+      else return sizeof(DiskType);
+    }
+
+    /// rows written plus rows still in the buffer
+    virtual std::size_t rows() const final override {
+      return i_file_ + buffer_.size();
+    }
+
+    /// allocated length of buffer
+    virtual std::size_t bytes() const final override {
+      return buffer_.capacity() * sizeof(AtomicType);
+    }
+
+    /// flush and then drop the allocation of the buffer
+    virtual void release() final override {
+      flush();
+      released_ = true;
+      buffer_.clear();
+      buffer_.shrink_to_fit();
+    }
+
+    /// save the cleared value n times, see Writer::pad
+    virtual void pad(std::size_t n) final override {
+      AtomicType cleared{};
+      if constexpr (std::numeric_limits<AtomicType>::is_specialized) {
+        cleared = std::numeric_limits<AtomicType>::min();
+      }
+      for (std::size_t i{0}; i < n; i++) save(cleared);
     }
-    /// destruct the in-memory buffer
-    virtual ~Buffer() = default;
     /**
      * Put the new value into the buffer
      *
-     * If the buffer goes over the maximum length of the buffer,
-     * then we call Buffer::flush
+     * If the buffer reaches the maximum length of the buffer,
+     * then we write it out. Before the dataset is created,
+     * the maximum length is zero and we keep every value.
      *
      * @param[in] val data to append to the dataset
      */
     void save(const AtomicType& val) {
       buffer_.push_back(val);
-      if (buffer_.size() > this->max_len_) flush();
+      if (this->max_len_ > 0 and buffer_.size() >= this->max_len_) flush_chunks();
     }
 
     /**
-     * Flush our in-memory buffer onto disk
+     * Put the new values into the buffer
+     *
+     * Contiguous values are appended with a single insertion, otherwise
+     * we step through the values stride bytes at a time. Then, like the
+     * single-value save, we write out the full chunks if the buffer has
+     * reached its maximum length.
      *
-     * We leave early if the buffer is empty.
+     * @param[in] vals pointer to the first value to append
+     * @param[in] n number of values to append
+     * @param[in] stride number of bytes between successive values
+     */
+    void save(const AtomicType* vals, std::size_t n, std::size_t stride) {
+      if (stride == sizeof(AtomicType)) {
+        buffer_.insert(buffer_.end(), vals, vals + n);
+      } else {
+        const char* val{reinterpret_cast<const char*>(vals)};
+        buffer_.reserve(buffer_.size() + n);
+        for (std::size_t i{0}; i < n; i++, val += stride) {
+          buffer_.push_back(*reinterpret_cast<const AtomicType*>(val));
+        }
+      }
+      if (this->max_len_ > 0 and buffer_.size() >= this->max_len_) flush_chunks();
+    }
+
+    /**
+     * Flush our entire in-memory buffer onto disk
+     *
+     * We leave early if the buffer is empty. The dataset must
+     * have been created before flushing (see Writer::flush).
      * This is helpful for the case where the number of elements
      * in the dataset happen to be an exact multiple of the buffer
      * size. Then the buffer would be empty at the time that
      * Writer::~Writer is called which calls all Buffers to flush
      * in order to avoid data loss.
      *
+     * @throws HighFive::DataSetException if unable to extend or
+     * write to the DataSet.
+     */
+    virtual void flush() final override {
+      if (buffer_.size() == 0) return;
+      write_out(buffer_.size());
+    }
+
+    /**
+     * Append rows from a dataset in another file
+     *
+     * If the input dataset is laid out like ours (Writer::same_layout),
+     * we copy rows one at a time until both the input and our dataset
+     * are at the start of a chunk, then copy the whole chunks still
+     * compressed, and finally copy the rows left at the end one at a
+     * time. The copied chunks are written directly into our dataset
+     * after flushing the buffer so that the rows stay in order.
+     *
+     * If the input dataset is laid out differently or its chunks
+     * never line up with ours, all of the rows are read and saved
+     * in batches of our buffer length.
+     *
+     * @param[in] src dataset to copy from
+     * @param[in] i_src index of first row in src to copy
+     * @param[in] n number of rows to copy
+     */
+    void copy(const HighFive::DataSet& src, std::size_t i_src, std::size_t n) {
+      std::size_t len{this->max_len_};
+      bool raw{false};
+      if (this->created() and rows() % len == i_src % len) {
+        std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+        raw = same_layout(src.getId(), this->set_->getId(), len);
+      }
+      if (not raw) {
+        copy_values(src, i_src, n);
+        return;
+      }
+      // rows before the first chunk boundary
+      std::size_t head{std::min(n, (len - i_src % len) % len)};
+      copy_values(src, i_src, head);
+      i_src += head;
+      n -= head;
+      std::size_t num_chunks{n / len};
+      if (num_chunks > 0) {
+        flush();
+        std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+        std::size_t new_extent{i_file_ + num_chunks*len};
+        if (this->set_->getDimensions().at(0) < new_extent) {
+          this->set_->resize({new_extent});
+        }
+        for (std::size_t i_chunk{0}; i_chunk < num_chunks; i_chunk++) {
+          copy_chunk(src.getId(), i_src, this->set_->getId(), i_file_);
+          i_src += len;
+          i_file_ += len;
+        }
+        n -= num_chunks*len;
+      }
+      copy_values(src, i_src, n);
+    }
+
+   private:
+    /**
+     * Read rows from a dataset in another file and save them
+     *
+     * The rows are read in batches of our buffer length (or all at once
+     * if our dataset has not been created yet) while holding the hdf5_mutex
+     * and then saved into the buffer like any other span.
+     *
+     * @param[in] src dataset to copy from
+     * @param[in] i_src index of first row in src to copy
+     * @param[in] n number of rows to copy
+     */
+    void copy_values(const HighFive::DataSet& src, std::size_t i_src, std::size_t n) {
+      std::size_t batch{this->max_len_ > 0 ? this->max_len_ : n};
+      while (n > 0) {
+        std::size_t len{std::min(n, batch)};
+        std::vector<DiskType> vals;
+        {
+          std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+          if constexpr (std::is_same_v<AtomicType, bool>) {
+            vals.resize(len);
+            src.select({i_src}, {len}).read(vals.data(), create_enum_bool());
+          } else {
+            src.select({i_src}, {len}).read(vals);
+          }
+        }
+        if constexpr (std::is_same_v<AtomicType, bool>) {
+          for (const auto& v : vals) save(v == Bool::TRUE);
+        } else {
+          save(vals.data(), len, sizeof(AtomicType));
+        }
+        i_src += len;
+        n -= len;
+      }
+    }
+
+    /**
+     * Flush the full chunks of our buffer onto disk
+     *
+     * Any elements beyond the last full chunk are kept in the buffer,
+     * so that (besides the final flush) our writes are aligned with the
+     * chunks of the dataset.
+     */
+    void flush_chunks() {
+      write_out(buffer_.size() - buffer_.size() % this->max_len_);
+    }
+
+    /**
+     * Write the first n elements of our buffer onto disk
+     *
+     * The location in the file that the elements will be written to
+     * is determined here, so the file index is updated immediately.
+     * The elements are moved out of the buffer into a shared vector so
+     * that they can be handed to the other threads. If we are writing
+     * asynchronously, the write is submitted to the IOThread, otherwise
+     * we write the elements now. In both cases, we re-reserve the maximum
+     * length of the buffer to prepare for another chunk of data unless
+     * we have been released to stay within the memory budget.
+     *
+     * @param[in] n number of elements from the front of the buffer to write
+     */
+    void write_out(std::size_t n) {
+      std::size_t i_file{i_file_};
+      i_file_ += n;
+      auto full{std::make_shared<std::vector<AtomicType>>()};
+      if (n == buffer_.size()) {
+        full->swap(buffer_);
+      } else {
+        full->assign(buffer_.begin(), buffer_.begin() + n);
+        buffer_.erase(buffer_.begin(), buffer_.begin() + n);
+      }
+      if (this->io_thread_) {
+        this->io_thread_->submit([this, i_file, full]() { write(i_file, full); });
+      } else {
+        write(i_file, full);
+      }
+      if (not released_) buffer_.reserve(this->max_len_);
+    }
+
+    /**
+     * Write the input data onto disk starting at the input index
+     *
      * We determine the new extent of the dataset given how many
-     * elements are in the buffer, then we resize the dataset
-     * that is on disk to this new extent.
+     * elements are being written, then we resize the dataset
+     * that is on disk to this new extent (if it is not big enough
+     * already).
      *
-     * Then, we copy the buffer into the DataSet on disk using
+     * Then, we copy the data into the DataSet on disk using
      * a compile-time choice that handles the std::vector<bool>
      * specialization
      * [bug in HighFive](https://github.com/BlueBrain/HighFive/issues/490).
@@ -232,36 +794,202 @@ class Writer {
      * which mimics the serialization behavior of the bool type
      * understandable by h5py.
      *
-     * Finally, we update the file index, clear the buffer,
-     * and re-reserve the maximum length of the buffer to prepare
-     * for another chunk of data.
+     * If we have a ChunkCompressor, the full chunks within the data are
+     * handed to it and only the pieces of partial chunks are written
+     * through the HDF5 filters. Strings are variable length so they
+     * are always written through the HDF5 filters.
      *
-     * @throws HighFive::DataSetException if unable to extend or
-     * write to the DataSet.
+     * The HDF5 calls are done while holding the hdf5_mutex since this
+     * may be called from the IOThread. The mutex is not held while
+     * submitting chunks to the ChunkCompressor since it needs the mutex
+     * to finish the chunks it already has.
+     *
+     * @param[in] i_file index in the dataset to start writing at
+     * @param[in] data elements to write
      */
-    virtual void flush() final override {
-      if (buffer_.size() == 0) return;
-      std::size_t new_extent = i_file_ + buffer_.size();
-      // throws if not created yet
-      if (this->set_.getDimensions().at(0) < new_extent) {
-        this->set_.resize({new_extent});
-      }
+    void write(std::size_t i_file, std::shared_ptr<const std::vector<AtomicType>> data) {
+      Timing::Scope scope{this->writer_.timing_, this->writer_.write_timer_};
+      Trace::Span span{"Writer::write", "io", true, this->path_};
+      std::shared_ptr<const std::vector<DiskType>> disk;
       if constexpr (std::is_same_v<AtomicType, bool>) {
-        // handle bool specialization
-        std::vector<Bool> buff;
-        buff.reserve(buffer_.size());
-        for (const auto& v : buffer_) buff.push_back(v ? Bool::TRUE : Bool::FALSE);
-        this->set_.select({i_file_}, {buffer_.size()}).write(buff);
+        auto buff{std::make_shared<std::vector<Bool>>()};
+        buff->reserve(data->size());
+        for (const auto& v : *data) buff->push_back(v ? Bool::TRUE : Bool::FALSE);
+        disk = buff;
       } else {
-        this->set_.select({i_file_}, {buffer_.size()}).write(buffer_);
+        disk = data;
       }
-      i_file_ += buffer_.size();
-      buffer_.clear();
-      buffer_.reserve(this->max_len_);
+      std::size_t new_extent = i_file + disk->size();
+      {
+        std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+        // throws if not created yet
+        if (this->set_->getDimensions().at(0) < new_extent) {
+          this->set_->resize({new_extent});
+        }
+      }
+      if constexpr (not std::is_same_v<AtomicType, std::string>) {
+        if (this->compressor_) {
+          std::size_t i{0};
+          while (i < disk->size()) {
+            std::size_t pos{i_file + i};
+            std::size_t len{std::min(disk->size() - i, this->max_len_ - pos % this->max_len_)};
+            if (len == this->max_len_) {
+              this->compressor_->submit(this->set_->getId(), pos,
+                  reinterpret_cast<const char*>(disk->data() + i), len, sizeof(DiskType), disk);
+            } else {
+              std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+              this->set_->select({pos}, {len}).write(
+                  std::vector<DiskType>(disk->begin() + i, disk->begin() + i + len));
+            }
+            i += len;
+          }
+          return;
+        }
+      }
+      std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+      this->set_->select({i_file}, {disk->size()}).write(*disk);
     }
   };
 
  private:
+  /**
+   * Get the Buffer for the dataset at the passed path
+   *
+   * If the path does not have a Buffer created for it yet,
+   * we create a new Buffer to write to it. Unless we are still
+   * watching the first events to adapt the chunk sizes, we also
+   * create the DataSet now.
+   *
+   * @throws std::bad_cast if mismatched type is passed to buffer
+   * @throws HighFive::DataSetException if unable to create data set
+   *
+   * @param[in] path full in-file path to the dataset
+   * @return reference to the Buffer for that dataset
+   */
+  template <typename AtomicType>
+  Buffer<AtomicType>& buffer(const std::string& path) {
+    auto buff_it{buffers_.find(path)};
+    if (buff_it == buffers_.end()) {
+      buff_it = buffers_.emplace(path, 
+          std::make_unique<Buffer<AtomicType>>(*this, path, io_thread_.get(),
+                                               compressor_.get())).first;
+      if (events_ >= chunk_adapt_events_) {
+        buff_it->second->create(chunk_length(*buff_it->second));
+      }
+    }
+    return dynamic_cast<Buffer<AtomicType>&>(*buff_it->second);
+  }
+
+  /**
+   * Create the DataSet at the passed path
+   *
+   * - the length of the chunks is chosen by the caller and is also
+   *    used as the length of the Buffer, this is done on purpose
+   * - if the type is a bool, we define the HighFive type to be
+   *    our custom enum which mimics the type used by h5py
+   *
+   * The creation properties are shared by all of our datasets,
+   * so the chunking is set right before creating each one.
+   *
+   * @throws HighFive::DataSetException if unable to create data set
+   *
+   * @param[in] path full in-file path to the dataset
+   * @param[in] chunk_len number of rows in each chunk
+   * @return the newly created dataset
+   */
+  template <typename AtomicType>
+  HighFive::DataSet create_dataset(const std::string& path, std::size_t chunk_len) {
+    std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+    HighFive::DataType t;
+    if constexpr (std::is_same_v<AtomicType,bool>) {
+      t = create_enum_bool();
+    } else {
+      t = HighFive::AtomicType<AtomicType>();
+    }
+    create_props_.add(HighFive::Chunking({chunk_len}));
+    auto ds = file_->createDataSet(path, space_, t, create_props_);
+    ds.createAttribute(constants::TYPE_ATTR_NAME, boost::core::demangle(typeid(AtomicType).name()));
+    ds.createAttribute(constants::VERS_ATTR_NAME, 0);
+    return ds;
+  }
+
+  /**
+   * Are the two datasets laid out the same on disk?
+   *
+   * The datasets have the same layout if they have the same fixed-length
+   * type, are both chunked with the input chunk length, and have the same
+   * filters with the same parameters. Then a compressed chunk from
+   * one can be written into the other without decompressing it.
+   *
+   * @note must be called while holding the hdf5_mutex
+   *
+   * @param[in] src ID of dataset to copy from
+   * @param[in] dst ID of dataset to copy to
+   * @param[in] chunk_len length of chunks in dst
+   * @return true if raw chunks can be copied from src to dst
+   */
+  static bool same_layout(hid_t src, hid_t dst, std::size_t chunk_len);
+
+  /**
+   * Copy a chunk from one dataset to another without decompressing it
+   *
+   * @note must be called while holding the hdf5_mutex
+   * and dst must already be extended to include the chunk
+   *
+   * @throws Exception if unable to read or write the chunk
+   *
+   * @param[in] src ID of dataset to copy from
+   * @param[in] i_src index of first row of the chunk in src
+   * @param[in] dst ID of dataset to copy to
+   * @param[in] i_dst index of first row of the chunk in dst
+   */
+  static void copy_chunk(hid_t src, std::size_t i_src, hid_t dst, std::size_t i_dst);
+
+  /**
+   * Determine the chunk length for the dataset of the input buffer
+   *
+   * The length is `chunk_bytes` divided by the size of a row (or
+   * `rows_per_chunk` if either is zero). If we have watched some events
+   * and know the event limit, we then cap this length at the number of
+   * rows we expect the dataset to have at the end.
+   *
+   * @param[in] buff buffer for the dataset about to be created
+   * @return number of rows in each chunk of the dataset
+   */
+  std::size_t chunk_length(const BufferHandle& buff) const;
+
+  /**
+   * Create the datasets that have not been created yet
+   *
+   * This is done once we have watched `chunk_adapt_events` events
+   * or when flushing before that many events have been saved.
+   */
+  void create_pending();
+
+  /**
+   * Keep the memory of our buffers within the memory budget
+   *
+   * We record the peak memory of the buffers and, if there is a
+   * budget and we are over it, we release the largest buffer
+   * (see BufferHandle::release) until we are within the budget
+   * or there are no more buffers that can be released. Buffers whose
+   * dataset has not been created yet cannot be released.
+   */
+  void enforce_budget();
+
+ private:
+  /// io::Data retrieves and keeps the Buffers for atomic types
+  template <typename DataType, typename Enable> friend class Data;
+
+  /**
+   * Get the unique ID of this writer
+   * @return ID unique among all writers created in this process
+   */
+  std::size_t id() const { return id_; }
+
+ private:
+  /// unique ID for this writer, see Writer::id
+  std::size_t id_;
   /**
    * our highfive file
    *
@@ -278,8 +1006,28 @@ class Writer {
   std::size_t entries_;
   /// number of rows to keep in each chunk
   std::size_t rows_per_chunk_;
+  /// target number of bytes in each chunk, zero to use rows_per_chunk_ for all
+  std::size_t chunk_bytes_;
+  /// number of events to watch before creating datasets, zero to create immediately
+  std::size_t chunk_adapt_events_;
+  /// number of events that have been saved
+  std::size_t events_;
+  /// maximum bytes held by our buffers, zero for no limit
+  std::size_t memory_budget_;
+  /// the most bytes held by our buffers at once
+  std::size_t peak_bytes_{0};
   /// our in-memory buffers for data to be written to disk
   std::unordered_map<std::string, std::unique_ptr<BufferHandle>> buffers_;
+  /// thread writing full buffers in the background, nullptr if writing synchronously
+  std::unique_ptr<IOThread> io_thread_;
+  /// pool compressing full chunks, nullptr if using the HDF5 filters
+  std::unique_ptr<ChunkCompressor> compressor_;
+  /// readers with copies into us waiting, see Writer::copying
+  std::vector<Reader*> copying_;
+  /// timers to record the writes into, nullptr if not timing
+  Timing* timing_{nullptr};
+  /// id of the timer of writing a buffer, see Writer::time
+  std::size_t write_timer_{0};
 };
 
 }  // namespace fire::h5
@@ -1,11 +1,23 @@
 #ifndef FIRE_IO_H5_READER_H
 #define FIRE_IO_H5_READER_H
 
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <future>
+
 // using HighFive
 #include <highfive/H5File.hpp>
 
 #include "fire/io/Reader.h"
 #include "fire/io/Atomic.h"
+#include "fire/io/IOThread.h"
+#include "fire/io/Trace.h"
+#include "fire/io/Writer.h"
+
+namespace fire::io {
+template <typename DataType, typename Enable> class Data;
+}
 
 namespace fire::io::h5 {
 
@@ -18,6 +30,27 @@ namespace fire::io::h5 {
  * in a seamless manner so that individual entries can be requested at
  * a time without making disk read operation each time Reader::load is
  * called.
+ *
+ * ## Prefetching
+ * If the `prefetch` parameter is set to true, the next chunk of each
+ * dataset is read on a background IOThread while the current chunk is
+ * being consumed. Each dataset has at most one chunk in flight, so
+ * the memory held is bounded to two chunks per dataset. When a chunk
+ * is needed before the background read has finished, we wait for it
+ * and record the time spent waiting (see prefetchStallTime).
+ *
+ * ## Memory Budget
+ * If the `memory_budget` parameter is greater than zero, the buffers
+ * are kept from holding more than that many megabytes all together.
+ * Whenever the buffers are over the budget, the largest buffer is halved
+ * (down to a single chunk of its dataset) until the buffers fit within
+ * the budget. The peak memory held by the buffers is recorded either
+ * way (see peakBufferBytes).
+ *
+ * ## Buffer Handles
+ * Like io::Writer, the io::Data wrapping atomic types are allowed to
+ * keep a reference to their typed Buffer, using our unique ID to check
+ * that they are still reading from the same Reader.
  */
 class Reader : public ::fire::io::Reader {
  public:
@@ -36,6 +69,8 @@ class Reader : public ::fire::io::Reader {
    *    once-per-event atomic type) under the name constants::EVENT_HEADER_NUMBER
    * 2. The EventHeader is created under a io::Data named
    *    constants::EVENT_GROUP/constants::EVENT_HEADER_NAME
+   * If the data set does not exist, no events were saved into
+   * the file (e.g. all of them were dropped) and it has no entries.
    *
    * We inspect the size of the dataset located at
    *  constants::RUN_HEADER_NAME/constants::NUMBER_NAME
@@ -45,8 +80,19 @@ class Reader : public ::fire::io::Reader {
    *
    * @throws HighFive::Exception if file is not accessible.
    * @param[in] name file name to open and read
+   * @param[in] ps parameters configuring how we read, only `prefetch` is used
+   */
+  Reader(const std::string& name,
+         const config::Parameters& ps = config::Parameters());
+
+  /**
+   * Close the file
+   *
+   * We finish any prefetching reads and then close the datasets and
+   * the file while holding the hdf5_mutex so that any IOThread accessing
+   * HDF5 is not disrupted.
    */
-  Reader(const std::string& name);
+  ~Reader();
 
   /**
    * Load the next event into the passed data
@@ -59,6 +105,29 @@ class Reader : public ::fire::io::Reader {
    */
   virtual void load_into(BaseData& d) final override;
 
+  /**
+   * Seek the passed data to the input entry
+   *
+   * We call the data's seek function with a reference to ourselves,
+   * so this does not load any of the entries in between.
+   *
+   * @param[in] d Data to move
+   * @param[in] i_entry entry index for the next load to read
+   */
+  virtual void seek_into(BaseData& d, std::size_t i_entry) final override;
+
+  /**
+   * Skip the passed data to the input entry
+   *
+   * Since we can seek, this is the same as seek_into and
+   * the skipped entries are never read.
+   *
+   * @param[in] d Data to move
+   * @param[in] i_entry entry index for the next load to read
+   * @param[in] n number of entries being skipped (unused)
+   */
+  virtual void skip_into(BaseData& d, std::size_t i_entry, std::size_t n) final override;
+
   /**
    * Get the event objects available in the file
    *
@@ -153,12 +222,38 @@ class Reader : public ::fire::io::Reader {
    */
   inline std::size_t runs() const final override { return runs_; }
 
+  /**
+   * Get the total time spent waiting on prefetched chunks
+   *
+   * This is summed over all of the datasets that have been read
+   * and is always zero if we are not prefetching.
+   *
+   * @return seconds spent waiting for the prefetch thread
+   */
+  virtual double prefetchStallTime() const final override;
+
+  /**
+   * Get the most memory held by our buffers at once
+   *
+   * The memory is counted as the length of each buffer
+   * (two chunks if prefetching) times the size of its type.
+   *
+   * @return peak number of bytes held by the buffers
+   */
+  virtual std::size_t peakBufferBytes() const final override { return peak_bytes_; }
+
   /**
    * We can copy
    * @return true
    */
   virtual bool canCopy() const final override { return true; }
 
+  /**
+   * We can seek
+   * @return true
+   */
+  virtual bool canSeek() const final override { return true; }
+
   /**
    * Copy the input data set to the output file
    *
@@ -167,6 +262,12 @@ class Reader : public ::fire::io::Reader {
    * noone has accessed it with Event::get yet so an in-memory class object
    * has not been created for it yet.
    *
+   * The entries are not copied right away. Instead, consecutive entries
+   * of the same object are gathered into a range which is copied all at
+   * once (see MirrorObject::copy) when an entry that does not follow
+   * the range is copied or when finishCopies is called. This allows
+   * whole chunks to be copied without decompressing them.
+   *
    * @param[in] i_entry entry we are currently on
    * @param[in] path full event object name
    * @param[in] output handle to the writer writing the output file
@@ -174,6 +275,30 @@ class Reader : public ::fire::io::Reader {
   virtual void copy(unsigned long int i_entry, const std::string& path, 
       Writer& output) final override;
 
+  /**
+   * Pad the input data set in the output file
+   *
+   * The structure is mirrored like for copy and the cleared entries
+   * are written right away (see MirrorObject::pad), so this must
+   * be called before the first entry of the object is copied.
+   *
+   * @param[in] path full event object name
+   * @param[in] n number of entries to pad
+   * @param[in] output handle to the writer writing the output file
+   */
+  virtual void pad(const std::string& path, std::size_t n,
+      Writer& output) final override;
+
+  /**
+   * Copy the ranges of entries waiting to be copied
+   *
+   * We do this when we are destroyed and the Writer has us do it
+   * when it is flushed (see Writer::copying), so it only needs to be
+   * called before an object that was being copied starts being saved
+   * through io::Data instead.
+   */
+  virtual void finishCopies() final override;
+
   /**
    * Try to load a single value of an atomic type into the input handle
    *
@@ -196,13 +321,41 @@ class Reader : public ::fire::io::Reader {
     static_assert(
         is_atomic_v<AtomicType>,
         "Type not supported by HighFive atomic made its way to Reader::load");
-    if (buffers_.find(path) == buffers_.end()) {
-      // first load attempt, we will find out if dataset exists in file here
-      buffers_.emplace(path, std::make_unique<Buffer<AtomicType>>(
-                                 rows_per_chunk_, file_.getDataSet(path)));
-    }
+    buffer<AtomicType>(path).read(val);
+  }
 
-    dynamic_cast<Buffer<AtomicType>&>(*buffers_[path]).read(val);
+  /**
+   * Load a span of atomic types from the dataset at the passed path
+   *
+   * This is the bulk version of load, the span is copied out of the
+   * Buffer directly, only splitting the copy where the Buffer needs
+   * to load the next chunk of data from disk. Loading zero elements
+   * does nothing and, in particular, does not require the dataset
+   * to exist.
+   *
+   * The elements of the span are separated by stride bytes so that
+   * we can scatter into the same member of an array of objects. The
+   * default stride is for a contiguous array of elements.
+   *
+   * @note std::vector<bool> does not hold its elements in an array
+   * so it cannot be loaded through this method.
+   *
+   * @throws std::bad_cast if mismatched type is passed
+   * @throws HighFive::DataSetException if requested dataset doesn't exist
+   *
+   * @param[in] path Full in-file path to dataset to load
+   * @param[out] vals pointer to the first element to load into
+   * @param[in] n number of elements to load
+   * @param[in] stride number of bytes between successive elements
+   */
+  template <typename AtomicType>
+  void load(const std::string& path, AtomicType* vals, std::size_t n,
+            std::size_t stride = sizeof(AtomicType)) {
+    static_assert(
+        is_atomic_v<AtomicType>,
+        "Type not supported by HighFive atomic made its way to Reader::load");
+    if (n == 0) return;
+    buffer<AtomicType>(path).read(vals, n, stride);
   }
 
   /// never want to copy a reader
@@ -211,6 +364,88 @@ class Reader : public ::fire::io::Reader {
   void operator=(const Reader&) = delete;
 
  private:
+  /// io::Data retrieves and keeps the Buffers for atomic types
+  template <typename DataType, typename Enable> friend class ::fire::io::Data;
+  template <typename AtomicType> class Buffer;
+  class MirrorObject;
+
+  /**
+   * Get the unique ID of this reader
+   * @return ID unique among all h5::Readers created in this process
+   */
+  std::size_t id() const { return id_; }
+
+  /**
+   * Get the Buffer for the dataset at the passed path
+   *
+   * If the path does not exist in our list of buffers,
+   * then we create a new buffer for the requested type and
+   * load the first chunk of data into memory. The length of the
+   * buffer follows the chunks of the dataset (see chunk_length).
+   *
+   * @throws std::bad_cast if mismatched type is passed
+   * @throws HighFive::DataSetException if requested dataset doesn't exist
+   *
+   * @param[in] path Full in-file path to dataset
+   * @return reference to the Buffer for that dataset
+   */
+  template <typename AtomicType>
+  Buffer<AtomicType>& buffer(const std::string& path) {
+    auto buff_it{buffers_.find(path)};
+    if (buff_it == buffers_.end()) {
+      std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+      // first load attempt, we will find out if dataset exists in file here
+      auto ds{file_->getDataSet(path)};
+      // smallest whole number of chunks holding at least rows_per_chunk_ rows
+      std::size_t chunk{chunk_length(ds)};
+      std::size_t len{chunk * ((rows_per_chunk_ + chunk - 1) / chunk)};
+      buff_it = buffers_.emplace(path, std::make_unique<Buffer<AtomicType>>(
+                                 len, chunk, ds, prefetch_.get())).first;
+      enforce_budget();
+    }
+    return dynamic_cast<Buffer<AtomicType>&>(*buff_it->second);
+  }
+
+  /**
+   * Get the offset of a row in the content of a container
+   *
+   * The content of the container at row i_row of its size dataset
+   * starts at the sum of the sizes before it. The size dataset is read
+   * in full the first time an offset within it is requested and the
+   * cumulative sums are cached, so later offsets are a single lookup.
+   *
+   * @param[in] size_path full in-file path to the size dataset
+   * @param[in] i_row index of the row in the size dataset
+   * @return index of the first element of that row in the content
+   */
+  std::size_t offset(const std::string& size_path, std::size_t i_row);
+
+  /**
+   * Determine the length of the chunks of the input dataset
+   *
+   * The buffers read whole chunks at a time so that each read from
+   * disk decompresses the chunks only once. Unchunked datasets are
+   * treated as if their chunks are rows_per_chunk_ rows long.
+   *
+   * @note must be called while holding the hdf5_mutex
+   *
+   * @param[in] ds dataset to be read
+   * @return number of rows in each chunk
+   */
+  std::size_t chunk_length(const HighFive::DataSet& ds) const;
+
+  /**
+   * Keep the memory of our buffers within the memory budget
+   *
+   * We record the peak memory of the buffers and, if there is a
+   * budget and we are over it, we shrink the largest buffer
+   * (see BufferHandle::shrink) until we are within the budget
+   * or none of the buffers can be shrunk any further.
+   * The buffers are only created on the first read of each
+   * dataset, so this is called when a new buffer is created.
+   */
+  void enforce_budget();
+
   /**
    * Mirror the structure of the passed path from us into the output file
    *
@@ -219,6 +454,18 @@ class Reader : public ::fire::io::Reader {
    */
   void mirror(const std::string& path, Writer& output);
 
+  /**
+   * Get the mirror object for the passed path
+   *
+   * The first time an object is mirrored, we mirror its structure
+   * into the output file and create its mirror object.
+   *
+   * @param[in] path full event object name
+   * @param[in] output output file to mirror the structure to
+   * @return mirror object for the path
+   */
+  MirrorObject& mirrorObject(const std::string& path, Writer& output);
+
  private:
   /**
    * Type-less handle to the Buffer
@@ -231,17 +478,26 @@ class Reader : public ::fire::io::Reader {
    protected:
     /// the maximum length of the buffer
     std::size_t max_len_;
+    /// the length of the chunks in the dataset, the minimum length of the buffer
+    std::size_t chunk_len_;
     /// the HDF5 dataset we are reading from
     HighFive::DataSet set_;
+    /// thread to read the next chunk on, nullptr if not prefetching
+    IOThread* prefetch_;
+    /// time spent waiting for prefetched chunks
+    std::chrono::duration<double> stall_{0.};
    public:
     /**
      * Define the size of the in-memory buffer and the set we are reading from
      *
      * @param[in] max maximum number of elements allowed in-memory
+     * @param[in] chunk length of chunks in the dataset, max is a multiple of it
      * @param[in] s DataSet we are reading from
+     * @param[in] prefetch thread to read next chunk on, nullptr to not prefetch
      */
-    explicit BufferHandle(std::size_t max, HighFive::DataSet s)
-        : max_len_{max}, set_{s} {}
+    explicit BufferHandle(std::size_t max, std::size_t chunk, HighFive::DataSet s,
+                          IOThread* prefetch)
+        : max_len_{max}, chunk_len_{chunk}, set_{s}, prefetch_{prefetch} {}
     /// virtual destructor to pass on to derived types
     virtual ~BufferHandle() = default;
     /**
@@ -252,6 +508,33 @@ class Reader : public ::fire::io::Reader {
      * the BufferHandle class which is meant to be abstract.
      */
     virtual void load() = 0;
+    /**
+     * Get the time spent waiting for prefetched chunks
+     * @return duration we have waited for the prefetch thread
+     */
+    std::chrono::duration<double> stall() const { return stall_; }
+    /**
+     * Get the memory this buffer holds when full
+     *
+     * Strings are counted by the size of std::string itself.
+     *
+     * @return bytes of both the current and prefetched chunks
+     */
+    virtual std::size_t bytes() const = 0;
+    /**
+     * Can this buffer be shrunk?
+     * @return true if the buffer is longer than a single chunk
+     */
+    bool canShrink() const { return max_len_ > chunk_len_; }
+    /**
+     * Halve the maximum length of the buffer
+     *
+     * The length stays a whole number of chunks and the new length
+     * is used starting with the next chunk read from disk.
+     */
+    void shrink() {
+      max_len_ = std::max(chunk_len_, (max_len_ / 2) / chunk_len_ * chunk_len_);
+    }
   };
 
   /**
@@ -263,6 +546,10 @@ class Reader : public ::fire::io::Reader {
   class Buffer : public BufferHandle {
     /// the actual buffer of in-memory elements
     std::vector<AtomicType> buffer_;
+    /// the next chunk of elements being read by the prefetch thread
+    std::vector<AtomicType> next_;
+    /// signals when the next chunk has been read, invalid if not prefetching
+    std::future<void> next_ready_;
     /// the current index of data-set elements in the file
     std::size_t i_file_;
     /// the current index of data-set elements in-memory
@@ -275,22 +562,69 @@ class Reader : public ::fire::io::Reader {
      *
      * We initialize ourselves with the indices set to 0,
      * the entries read from the size of the dataset passed,
-     * and the buffer empty. Then we call our own Buffer::load method
-     * to get the first chunk of data into memory.
+     * and the buffer empty. The first chunk of data is loaded
+     * into memory by the first read, so that the length of the
+     * buffer can be shrunk to fit the memory budget before
+     * anything is read.
      *
      * @param[in] max size of the buffer
+     * @param[in] chunk length of chunks in the dataset
      * @param[in] s dataset to read from
+     * @param[in] prefetch thread to read next chunk on, nullptr to not prefetch
      */
-    explicit Buffer(std::size_t max, HighFive::DataSet s)
-        : BufferHandle(max, s), buffer_{}, i_file_{0}, i_memory_{0} {
+    explicit Buffer(std::size_t max, std::size_t chunk, HighFive::DataSet s,
+                    IOThread* prefetch)
+        : BufferHandle(max, chunk, s, prefetch), buffer_{}, i_file_{0}, i_memory_{0} {
       // get the number of entries for later checking
       entries_ = this->set_.getDimensions().at(0);
-      // do first load upon creation
-      this->load();
     }
-    /// nothing fancy, just clearing in-memory objects
-    virtual ~Buffer() = default;
+
+    /**
+     * Wait for any prefetch in flight since it references our members
+     */
+    virtual ~Buffer() {
+      if (next_ready_.valid()) next_ready_.wait();
+    }
+
+    /// full length of the buffer, doubled if prefetching
+    virtual std::size_t bytes() const final override {
+      return this->max_len_ * sizeof(AtomicType) * (this->prefetch_ ? 2 : 1);
+    }
     
+    /**
+     * Move to the input index of the dataset
+     *
+     * If the index is within the chunk in memory (or right after it),
+     * we just move our in-memory index and the next read loads the
+     * following chunk as usual. Otherwise, we drop any prefetched chunk and load
+     * the buffer starting at the chunk holding the index, so that our
+     * reads stay aligned with the chunks of the dataset.
+     *
+     * @param[in] i_row index in the dataset for the next read
+     */
+    void seek(std::size_t i_row) {
+      std::size_t start{i_file_ - buffer_.size()};
+      if (i_row >= start and i_row <= i_file_) {
+        i_memory_ = i_row - start;
+        return;
+      }
+      // the prefetched chunk is not the one after our new position
+      if (next_ready_.valid()) {
+        next_ready_.wait();
+        next_ready_ = std::future<void>();
+      }
+      buffer_.clear();
+      i_memory_ = 0;
+      if (i_row >= entries_) {
+        // reads past the end of the dataset are left to fail
+        i_file_ = i_row;
+        return;
+      }
+      i_file_ = i_row - i_row % this->chunk_len_;
+      this->load();
+      i_memory_ = i_row - (i_file_ - buffer_.size());
+    }
+
     /**
      * Read the next entry from the dataset into the input variable
      *
@@ -305,13 +639,95 @@ class Reader : public ::fire::io::Reader {
       out = buffer_[i_memory_];
       i_memory_++;
     }
-    
+
+    /**
+     * Read the next n entries from the dataset into the input span
+     *
+     * We copy as much as we can from the in-memory buffer,
+     * calling Buffer::load whenever we reach its end.
+     *
+     * @throws Exception if we attempt to read passed the end of the dataset
+     *
+     * @param[out] out pointer to first element to read into
+     * @param[in] n number of entries to read
+     * @param[in] stride number of bytes between successive elements of out
+     */
+    void read(AtomicType* out, std::size_t n, std::size_t stride) {
+      char* dest{reinterpret_cast<char*>(out)};
+      while (n > 0) {
+        if (i_memory_ == buffer_.size()) {
+          this->load();
+          if (buffer_.empty()) {
+            throw Exception("H5Read",
+                "Attempted to read passed the end of a dataset.", false);
+          }
+        }
+        std::size_t len = std::min(n, buffer_.size() - i_memory_);
+        if (stride == sizeof(AtomicType)) {
+          std::copy_n(buffer_.begin() + i_memory_, len,
+                      reinterpret_cast<AtomicType*>(dest));
+          dest += len*stride;
+        } else {
+          for (std::size_t i{i_memory_}; i < i_memory_ + len; i++, dest += stride) {
+            *reinterpret_cast<AtomicType*>(dest) = buffer_[i];
+          }
+        }
+        i_memory_ += len;
+        n -= len;
+      }
+    }
+
     /**
      * Load the next chunk of data into memory
      *
-     * We determine the size of the next chunk from our own
-     * maximum and the number of entries in the data set.
-     * We shrink the size of the next chunk depending on how
+     * If the next chunk is being prefetched, we wait for it to
+     * finish (recording how long we waited) and swap it into the
+     * in-memory buffer. Otherwise, we read it from disk now.
+     *
+     * After the next chunk is in memory, we update our indices by
+     * resetting the in-memory index to 0 and moving the file index
+     * by the size of the buffer. If we are prefetching and there
+     * are entries left, we then submit the read of the following
+     * chunk to the prefetch thread. The length of each chunk is
+     * decided when its read is started, so that shrinking the buffer
+     * does not change a read that is already in flight. Memory left
+     * over from a longer chunk is released.
+     *
+     * @note We assume that the downstream objects using this buffer
+     * know to stop processing before attempting to read passed the
+     * end of the data set.
+     */
+    virtual void load() final override {
+      Trace::Span span{"h5::Reader::Buffer::load", "io"};
+      if (next_ready_.valid()) {
+        auto start = std::chrono::steady_clock::now();
+        // re-throws any exception from the background read
+        next_ready_.get();
+        this->stall_ += std::chrono::steady_clock::now() - start;
+        buffer_.swap(next_);
+      } else {
+        fetch(i_file_, this->max_len_, buffer_);
+      }
+      if (buffer_.capacity() > this->max_len_) buffer_.shrink_to_fit();
+      // update indices
+      i_file_ += buffer_.size();
+      i_memory_ = 0;
+      // start reading the chunk after this one
+      if (this->prefetch_ and i_file_ < entries_) {
+        auto task = std::make_shared<std::packaged_task<void()>>(
+            [this, i_file = i_file_, len = this->max_len_]() { fetch(i_file, len, next_); });
+        next_ready_ = task->get_future();
+        this->prefetch_->submit([task]() { (*task)(); });
+      }
+    }
+
+   private:
+    /**
+     * Read the chunk starting at the input index into the input vector
+     *
+     * We determine the size of the chunk from the input
+     * length and the number of entries in the data set.
+     * We shrink the size of the chunk depending on how
      * many entries are left if we can't grab a whole maximum
      * sized chunk.
      *
@@ -321,23 +737,18 @@ class Reader : public ::fire::io::Reader {
      * due to the specialization of it **and** to translate
      * our custom enum fire::io::Bool into bools.
      *
-     * After reading the next chunk into memory, we update our
-     * indicies by resetting the in-memory index to 0 and moving
-     * the file index by the size of the buffer.
+     * The reading is done while holding the hdf5_mutex so that
+     * we do not collide with another IOThread using HDF5.
      *
-     * @note We assume that the downstream objects using this buffer
-     * know to stop processing before attempting to read passed the
-     * end of the data set. We enforce this with an assertion.
+     * @param[in] i_file index of first element in the file to read
+     * @param[in] len maximum number of elements to read
+     * @param[out] out vector to read the chunk into, replacing its contents
      */
-    virtual void load() final override {
+    void fetch(std::size_t i_file, std::size_t len, std::vector<AtomicType>& out) {
       // determine the length we want to request depending
       // on the number of entries left in the file
-      std::size_t request_len = this->max_len_;
-      if (request_len + i_file_ > entries_) {
-        request_len = entries_ - i_file_;
-        assert(request_len >= 0);
-      }
-      // load the next chunk into memory
+      std::size_t request_len = std::min(len, entries_ - i_file);
+      std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
       if constexpr (std::is_same_v<AtomicType,bool>) {
         /**
          * compile-time split for bools which
@@ -346,16 +757,14 @@ class Reader : public ::fire::io::Reader {
          */
         std::vector<Bool> buff;
         buff.resize(request_len);
-        this->set_.select({i_file_}, {request_len})
+        this->set_.select({i_file}, {request_len})
           .read(buff.data(),create_enum_bool());
-        buffer_.reserve(buff.size());
-        for (const auto& v : buff) buffer_.push_back(v == Bool::TRUE);
+        out.clear();
+        out.reserve(buff.size());
+        for (const auto& v : buff) out.push_back(v == Bool::TRUE);
       } else {
-        this->set_.select({i_file_}, {request_len}).read(buffer_);
+        this->set_.select({i_file}, {request_len}).read(out);
       }
-      // update indices
-      i_file_ += buffer_.size();
-      i_memory_ = 0;
     }
   };
 
@@ -373,14 +782,16 @@ class Reader : public ::fire::io::Reader {
   class MirrorObject {
     /// handle to the reader we are reading from
     Reader& reader_;
-    /// handle to the atomic data type once we get down to that point
-    std::unique_ptr<BaseData> data_;
+    /// copy rows of the atomic dataset once we get down to that point
+    std::function<void(unsigned long int, unsigned long int, Writer&)> copy_rows_;
+    /// pad rows of the atomic dataset once we get down to that point
+    std::function<void(unsigned long int, Writer&)> pad_rows_;
     /// handle to the size member of this object (if it exists)
-    std::unique_ptr<BaseData> size_member_;
+    std::unique_ptr<MirrorObject> size_member_;
+    /// path to the size member of this object (if it exists)
+    std::string size_path_;
     /// list of sub-objects within this object
     std::vector<std::unique_ptr<MirrorObject>> obj_members_;
-    /// the last entry that was copied
-    unsigned long int last_entry_{0};
 
    public:
     /**
@@ -389,24 +800,91 @@ class Reader : public ::fire::io::Reader {
     MirrorObject(const std::string& path, Reader& reader);
 
     /**
-     * Copy the n entries starting from i_entry
+     * Copy the n rows starting from i_row
+     *
+     * Atomic datasets are copied with Writer::copy, moving whole
+     * compressed chunks when possible. The rows of the content of
+     * containers start at the offset of i_row and end at the offset
+     * of i_row+n (see Reader::offset).
+     *
+     * @param[in] i_row index of first row to copy
+     * @param[in] n number of rows to copy
+     * @param[in] output writer to copy the rows to
+     */
+    void copy(unsigned long int i_row, unsigned long int n, Writer& output);
+
+    /**
+     * Append n cleared rows
+     *
+     * Atomic datasets are padded with Writer::pad. The padded entries
+     * of containers are empty, so only their size member is padded.
+     *
+     * @param[in] n number of rows to pad
+     * @param[in] output writer to pad the rows in
+     */
+    void pad(unsigned long int n, Writer& output);
+
+   private:
+    /**
+     * Create the functions copying and padding rows of the atomic dataset at the input path
+     *
+     * The dataset is opened once and held by the copying function.
+     *
+     * @tparam AtomicType type of data in the dataset
+     * @param[in] path full in-file path to the dataset
      */
-    void copy(unsigned long int i_entry, unsigned long int n, Writer& output);
+    template <typename AtomicType>
+    void atomic(const std::string& path) {
+      HighFive::DataSet src{reader_.file_->getDataSet(path)};
+      copy_rows_ = [src, path](unsigned long int i_row, unsigned long int n, Writer& output) {
+        output.template copy<AtomicType>(path, src, i_row, n);
+      };
+      pad_rows_ = [path](unsigned long int n, Writer& output) {
+        output.template pad<AtomicType>(path, n);
+      };
+    }
+  };
+
+  /// a range of entries waiting to be copied, see Reader::copy
+  struct PendingCopy {
+    /// first entry in range
+    unsigned long int start;
+    /// number of entries in range
+    unsigned long int n;
+    /// writer to copy to
+    Writer* output;
   };
 
  private:
-  /// our highfive file
-  HighFive::File file_;
+  /// unique ID for this reader, see Reader::id
+  std::size_t id_;
+  /**
+   * our highfive file
+   *
+   * we need it to be a smart pointer so that we can
+   * control when it is opened and closed
+   */
+  std::unique_ptr<HighFive::File> file_;
   /// the number of entries in this file, set in constructor
-  const std::size_t entries_;
+  std::size_t entries_;
   /// the number of runs in this file, set in constructor
-  const std::size_t runs_;
-  /// the number of rows to keep in each chunk, read from DataSet?
+  std::size_t runs_;
+  /// the minimum number of rows to read at a time
   std::size_t rows_per_chunk_{10000};
+  /// cumulative sums of the size datasets, see Reader::offset
+  std::unordered_map<std::string, std::vector<std::size_t>> offsets_;
+  /// maximum bytes held by our buffers, zero for no limit
+  std::size_t memory_budget_{0};
+  /// the most bytes held by our buffers at once
+  std::size_t peak_bytes_{0};
+  /// thread reading the next chunks in the background, nullptr if not prefetching
+  std::unique_ptr<IOThread> prefetch_;
   /// our in-memory buffers for the data to be read in from disk
   std::unordered_map<std::string, std::unique_ptr<BufferHandle>> buffers_;
   /// our in-memory mirror objects for data being copied to the output file without processing
   std::unordered_map<std::string, std::unique_ptr<MirrorObject>> mirror_objects_;
+  /// the ranges of entries waiting to be copied for each mirror object
+  std::unordered_map<std::string, PendingCopy> pending_copies_;
 };  // Reader
 
 }  // namespace fire::io::h5
@@ -38,8 +38,10 @@ class Reader : public ::fire::io::Reader {
    * we turn off ROOT's "feature" of handling standard Unix signals.
    *
    * @param[in] file_name file to open with ROOT
+   * @param[in] ps parameters configuring the reading, currently unused
    */
-  Reader(const std::string& file_name);
+  Reader(const std::string& file_name,
+         const config::Parameters& ps = config::Parameters());
 
   /**
    * Following the instructions in ::fire::io::Reader, we simply call the BaseData's
@@ -9,13 +9,49 @@ class OutputFile :
         Name of file to write
     rows_per_chunk : int, optional
         Number of "rows" in the output file to "chunk" together
+    chunk_bytes : int, optional
+        Target number of bytes in each chunk. If greater than zero, the number of
+        rows in each chunk is chosen for each dataset from the size of its type,
+        except for strings which stay at rows_per_chunk.
+    chunk_adapt_events : int, optional
+        Number of events to watch before creating the datasets. If greater than zero,
+        the chunks are also kept shorter than the number of rows each dataset is
+        expected to have by the end of processing.
+    compression_level : int, optional
+        Level of compression to use, Deflate and Blosc: 0 (none) - 9 (most),
+        Zstd: 1 - 22, ignored by LZ4
+    shuffle : bool, optional
+        Apply the Shuffle filter before compressing, Blosc uses its own bitshuffle
+    compression : str, optional
+        Compression algorithm: 'deflate', 'zstd', 'lz4', 'blosc', or 'none'.
+        All but 'deflate' and 'none' require the HDF5 filter plugins to be installed.
+    compression_threads : int, optional
+        Number of threads to compress chunks on, only for 'deflate' compression.
+        If zero, chunks are compressed by the HDF5 library itself.
+    memory_budget : int, optional
+        Maximum megabytes of output data to hold in memory before writing it,
+        zero for no limit
+    async_write : bool, optional
+        Compress and write full chunks on a background thread
+    max_in_flight : int, optional
+        Maximum number of full chunks waiting to be written when writing asynchronously
     """
 
-    def __init__(self, name, rows_per_chunk = 10000, compression_level = 6, shuffle = False) :
+    def __init__(self, name, rows_per_chunk = 10000, compression_level = 6, shuffle = False,
+            async_write = False, max_in_flight = 4, compression = 'deflate',
+            compression_threads = 0, chunk_bytes = 0, chunk_adapt_events = 0,
+            memory_budget = 0) :
         self.name = name
         self.rows_per_chunk = rows_per_chunk
         self.compression_level = compression_level
         self.shuffle = shuffle
+        self.async_write = async_write
+        self.max_in_flight = max_in_flight
+        self.compression = compression
+        self.compression_threads = compression_threads
+        self.chunk_bytes = chunk_bytes
+        self.chunk_adapt_events = chunk_adapt_events
+        self.memory_budget = memory_budget
 
     def __repr__(self) :
         return f'OutputFile({self.name})'
@@ -22,6 +22,12 @@ class Process:
         Class-wide reference to the last Process object to be constructed
     event_limit : int
         Maximum number events to process
+    first_entry : int
+        First entry of the input files to process, the entries are counted
+        across all of the input files as if they were one
+    last_entry : int
+        One past the last entry of the input files to process,
+        negative to process up to the end of the input files
     max_tries : int
         Maximum number of attempts to make in a row before giving up on an event. 
         Only used in Production Mode (no input files)
@@ -29,6 +35,44 @@ class Process:
         Run number for this process
     input_files : list of strings
         Input files to read in event data from and process
+    prefetch : bool
+        Read the next chunk of input data on a background thread while
+        the current chunk is being processed
+    input_memory_budget : int
+        Maximum megabytes of input data to hold in memory for each input file,
+        zero for no limit
+    lazy_load : bool
+        Only read an input event object when a processor asks for it,
+        skipping over the entries where it is not used
+    threads : int
+        Number of events to process at once on separate threads,
+        processors that are not thread safe are copied for each event in flight
+    ordered_output : bool
+        Save the events in the order they were read or generated when
+        using more than one thread, otherwise save them as they finish
+    pipeline : bool
+        Save the finished events on their own thread while the next
+        events are being read and processed, with one processing thread
+        the processors are shared between the events in flight
+    processor_threads : int
+        Number of threads to run the processors of an event on, processors that
+        declare the objects they consume and produce run at the same time as
+        the other processors they do not depend on. If a processor aborts the
+        event or fails, the independent processors after it may have already run.
+    timing : bool
+        Time each processor, the loading and saving of events, and the writing
+        of the output file to disk, the summary is printed at the end of the run
+        and written into the output file
+    counters : bool
+        Count the cycles, instructions, cache misses, and branch misses (or only
+        the page faults and context switches if hardware counters are not permitted)
+        of each timed part, enables timing and reports the rates per call
+    trace_file : str
+        File to write a timeline of processing to in the Chrome trace-event
+        JSON format, viewable in ui.perfetto.dev, empty to not trace
+    trace_every : int
+        Trace the processors and the loading and saving of every this many events,
+        the disk operations are always traced
     output_file : OutputFile
         Output file to write out event data to after processing
     storage : StorageControl
@@ -66,9 +110,22 @@ class Process:
         self.libraries = []
         self.pass_name = pass_name
         self.event_limit = -1
+        self.first_entry = 0
+        self.last_entry = -1
         self.max_tries = 1
         self.run = -1
         self.input_files = []
+        self.prefetch = False
+        self.input_memory_budget = 0
+        self.lazy_load = False
+        self.threads = 1
+        self.ordered_output = True
+        self.pipeline = False
+        self.processor_threads = 1
+        self.timing = False
+        self.counters = False
+        self.trace_file = ''
+        self.trace_every = 1
         self.output_file = OutputFile('')
         self.sequence = []
         self.drop_keep_rules = []
@@ -391,6 +448,8 @@ class Process:
         if (self.run>0): msg += "\n using run number %d"%(self.run)
         if (self.event_limit>0): msg += "\n Maximum events to process: %d"%(self.event_limit)
         else: msg += "\n No limit on maximum events to process"
+        if (self.first_entry>0 or self.last_entry>=0):
+            msg += "\n Input entries to process: %d - %d"%(self.first_entry, self.last_entry)
         msg += f'\n{str(self.conditions)}'
         msg += '\nProcessor sequence:'
         for proc in self.sequence:
@@ -16,7 +16,9 @@ class Processor:
     module : str
         Name of module the C++ class is in (i.e. the library that should be loaded)
     kwargs : dict
-        key word arguments to pass along to the derived processor
+        key word arguments to pass along to the derived processor,
+        including the optional lists 'consumes' and 'produces' with the names of
+        the event objects it gets and adds when processors are run at once
 
     See Also
     --------
@@ -3,6 +3,7 @@
 #include <sstream>
 
 #include "fire/Process.h"
+#include "fire/io/Trace.h"
 
 namespace fire {
 
@@ -36,6 +37,7 @@ void Conditions::onNewRun(RunHeader& rh) {
 
 ConditionsIntervalOfValidity Conditions::getConditionIOV(
     const std::string& condition_name) const {
+  std::lock_guard<std::mutex> lock{cache_mutex_};
   auto cacheptr = cache_.find(condition_name);
   if (cacheptr == cache_.end())
     return ConditionsIntervalOfValidity();
@@ -46,6 +48,7 @@ ConditionsIntervalOfValidity Conditions::getConditionIOV(
 const ConditionsObject* Conditions::getConditionPtr(
     const std::string& condition_name) {
   const EventHeader& context = process_.eventHeader();
+  std::lock_guard<std::mutex> lock{cache_mutex_};
   auto cacheptr = cache_.find(condition_name);
 
   if (cacheptr == cache_.end()) {
@@ -56,6 +59,7 @@ const ConditionsObject* Conditions::getConditionPtr(
           "No provider is available for : " + condition_name);
     }
 
+    io::Trace::Span span{"Conditions::fetch", "conditions", true, condition_name};
     const auto& [co, iov] = cpptr->second->getCondition(context);
     if (!co) {
       throw Exception("Conditions",
@@ -78,6 +82,7 @@ const ConditionsObject* Conditions::getConditionPtr(
       // if not, we release the old object
       cacheptr->second.provider->release(cacheptr->second.obj);
       // now ask for a new one
+      io::Trace::Span span{"Conditions::fetch", "conditions", true, condition_name};
       const auto& [co, iov] = cacheptr->second.provider->getCondition(context);
 
       if (!co) {
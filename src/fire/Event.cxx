@@ -1,63 +1,143 @@
 #include "fire/Event.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+
 namespace fire {
 
+std::size_t nextEventHandleId() {
+  static std::atomic<std::size_t> next{0};
+  return next++;
+}
+
 std::vector<Event::EventObjectTag> Event::search(const std::string& namematch,
                                       const std::string& passmatch,
                                       const std::string& typematch) const {
-  std::regex name_reg{namematch.empty() ? ".*" : namematch,
-                      std::regex::extended | std::regex::nosubs};
-  std::regex pass_reg{passmatch.empty() ? ".*" : passmatch,
-                      std::regex::extended | std::regex::nosubs};
-  std::regex type_reg{typematch.empty() ? ".*" : typematch,
-                      std::regex::extended | std::regex::nosubs};
+  auto access_lock{lockAccess()};
+  // searches made from changing strings would grow the caches without
+  // limit, so we start over when they are full
+  if (searches_.size() >= MAX_CACHED_SEARCHES) {
+    searches_.clear();
+    patterns_.clear();
+  }
+  auto pattern = [this](const std::string& match) -> const std::regex& {
+    auto compiled{patterns_.find(match)};
+    if (compiled == patterns_.end()) {
+      compiled = patterns_.emplace(match, std::regex{match.empty() ? ".*" : match,
+                     std::regex::extended | std::regex::nosubs}).first;
+    }
+    return compiled->second;
+  };
+
+  // only the objects that became available since the last time
+  // we did this search need to be matched
+  auto& [checked, indices] = searches_[namematch + '\0' + passmatch + '\0' + typematch];
+  if (checked < available_objects_.size()) {
+    const auto &name_reg{pattern(namematch)}, &pass_reg{pattern(passmatch)},
+               &type_reg{pattern(typematch)};
+    for (; checked < available_objects_.size(); checked++) {
+      if (available_objects_[checked].match(name_reg, pass_reg, type_reg))
+        indices.push_back(checked);
+    }
+  }
+
   std::vector<EventObjectTag> matches;
-  std::copy_if(available_objects_.begin(), available_objects_.end(), std::back_inserter(matches),
-               [&](const EventObjectTag& tag) {
-                 return tag.match(name_reg, pass_reg, type_reg);
-               });
+  matches.reserve(indices.size());
+  for (std::size_t i : indices) matches.push_back(available_objects_[i]);
   return matches;
 }
 
+Event::EventObjectTag& Event::makeAvailable(EventObjectTag tag) {
+  std::size_t i{available_objects_.size()};
+  std::string full_name{fullName(tag.name(), tag.pass())};
+  names_[tag.name()].push_back(i);
+  full_names_[full_name] = i;
+  available_paths_.push_back(io::constants::EVENT_GROUP+"/"+full_name);
+  copy_started_.push_back(false);
+  return available_objects_.emplace_back(std::move(tag));
+}
+
+namespace {
+
+/**
+ * Get the literal text that every match of the regex starts with
+ *
+ * We stop at the first special character of the extended grammar.
+ * If it makes the character before optional (or repeats it),
+ * that character is not part of the prefix either. Alternatives
+ * could start with anything so they do not have a prefix.
+ *
+ * @param[in] regex regular expression of the rule
+ * @return lower case literal prefix, empty if there is none
+ */
+std::string literalPrefix(const std::string& regex) {
+  static const std::string special{".[]()*+?{}|^$\\"};
+  if (regex.find('|') != std::string::npos) return "";
+  std::size_t start{regex.size() > 0 and regex[0] == '^' ? 1ul : 0ul};
+  std::size_t end{regex.find_first_of(special, start)};
+  if (end == std::string::npos) end = regex.size();
+  else if (end > start and (regex[end] == '*' or regex[end] == '?' or regex[end] == '{'))
+    end--;
+  std::string prefix{regex.substr(start, end - start)};
+  std::transform(prefix.begin(), prefix.end(), prefix.begin(),
+                 [](unsigned char c) { return std::tolower(c); });
+  return prefix;
+}
+
+}  // namespace
+
 bool Event::keep(const std::string& full_name, bool def) const {
-  // search through list BACKWARDS, meaning the last rule that applies will be
-  // the decision
-  auto rule_it{std::find_if(drop_keep_rules_.rbegin(), drop_keep_rules_.rend(),
-                            [&](const auto& rule_pair) {
-                              return std::regex_match(full_name,
-                                                      rule_pair.first);
-                            })};
+  auto decided{keep_decisions_.find(full_name)};
+  if (decided == keep_decisions_.end()) {
+    // search through list BACKWARDS, meaning the last rule that applies will be
+    // the decision
+    auto rule_it{std::find_if(drop_keep_rules_.rbegin(), drop_keep_rules_.rend(),
+                              [&](const DropKeepRule& rule) {
+                                return full_name.size() >= rule.prefix.size()
+                                   and std::equal(rule.prefix.begin(), rule.prefix.end(),
+                                        full_name.begin(), [](char p, unsigned char c) {
+                                          return p == std::tolower(c);
+                                        })
+                                   and std::regex_match(full_name, rule.regex);
+                              })};
+    std::optional<bool> decision;
+    if (rule_it != drop_keep_rules_.rend()) decision = rule_it->keep;
+    decided = keep_decisions_.emplace(full_name, decision).first;
+  }
   // no rules applied
-  return rule_it == drop_keep_rules_.rend() ? def : rule_it->second;
+  return decided->second.value_or(def);
 }
 
 Event::Event(io::Writer* output_file,
              const std::string& pass,
-             const std::vector<config::Parameters>& dk_rules)
-    : output_file_{output_file},
-      pass_{pass},
+             const std::vector<config::Parameters>& dk_rules,
+             bool lazy)
+    : header_{std::make_unique<EventHeader>()},
       input_file_{nullptr},
+      output_file_{output_file},
+      pass_{pass},
       i_entry_{0},
-      header_{std::make_unique<EventHeader>()} {
+      lazy_{lazy},
+      shared_{std::make_shared<SharedObjects>()} {
   /// register our event header with a data set for save/load
   //    we own the pointer in this special case so we can return both mutable
   //    and const references
-  auto& obj{objects_[EventHeader::NAME]};
+  auto& obj{objects_[newObject(EventHeader::NAME)]};
   obj.data_ = std::make_unique<io::Data<EventHeader>>(EventHeader::NAME,
                                                       nullptr,
                                                       header_.get()),
   obj.should_save_ = true;   // always save event header
   obj.should_load_ = false;  // don't load unless input files are passed
   obj.updated_ = false;      // not used for EventHeader
+  obj.in_output_ = true;     // saved without setting up the output file
   // construct rules from rule configuration parameters
   for (const auto& rule : dk_rules) {
     auto regex{rule.get<std::string>("regex")};
     try {
-      drop_keep_rules_.emplace_back(
-        std::piecewise_construct,
-        std::forward_as_tuple(regex,
-            std::regex::extended | std::regex::icase | std::regex::nosubs),
-        std::forward_as_tuple(rule.get<bool>("keep")));
+      drop_keep_rules_.push_back({
+          std::regex{regex, std::regex::extended | std::regex::icase | std::regex::nosubs},
+          literalPrefix(regex), rule.get<bool>("keep")});
     } catch (const std::regex_error&) {
       throw Exception("Config",
           "Drop/Keep regex '"+regex+"' not a proper regex.",false);
@@ -66,25 +146,132 @@ Event::Event(io::Writer* output_file,
 }
 
 void Event::save() {
-  for (auto& [_, obj] : objects_)
-    if (obj.should_save_) obj.data_->save(*output_file_);
+  sync();
+  for (auto& obj : objects_) {
+    if (obj.should_save_) {
+      if (not obj.in_output_) setUpOutput(obj.full_name_, obj);
+      catchUp(obj);
+      obj.data_->save(*output_file_);
+    }
+  }
 
-  for (const auto& tag : available_objects_) {
+  for (std::size_t i{0}; i < available_objects_.size(); i++) {
+    const auto& tag{available_objects_[i]};
     if (tag.keep() and not tag.loaded()) {
       // need to copy this event object from the input file
       // into the output file because it is supposed to be kept
       // but hasn't been loaded by the user
-      input_file_->copy(i_entry_, 
-          io::constants::EVENT_GROUP+"/"+fullName(tag.name(), tag.pass()), 
-          *output_file_);
+      const auto& path{available_paths_[i]};
+      bool first{false};
+      if (not copy_started_[i]) {
+        copy_started_[i] = true;
+        first = startCopying(path);
+      }
+      auto input_lock{lockInput()};
+      // the entries already in the output file did not have this object
+      if (first) input_file_->pad(path, output_file_->events(), *output_file_);
+      input_file_->copy(i_entry_, path, *output_file_);
     }
   }
+
+  for (const auto& path : missingCopies()) output_file_->padObject(path, 1);
+
+  output_file_->nextEvent();
 }
 
 void Event::load() {
   assert(input_file_);
-  for (auto& [_, obj] : objects_)
-    if (obj.should_load_) input_file_->load_into(*obj.data_);
+  for (std::size_t id{0}; id < objects_.size(); id++) {
+    auto& obj{objects_[id]};
+    if (not obj.should_load_) continue;
+    obj.behind_++;
+    // the header is always needed to follow the runs
+    if (not lazy_ or id == HEADER_ID) catchUp(obj);
+  }
+}
+
+void Event::catchUp(EventObject& obj) const {
+  if (obj.behind_ == 0) return;
+  auto input_lock{lockInput()};
+  // other events in flight move the input data as well
+  if (obj.behind_ > 1 or input_mutex_) {
+    input_file_->skip_into(*obj.data_, i_entry_, obj.behind_ - 1);
+  }
+  input_file_->load_into(*obj.data_);
+  obj.behind_ = 0;
+}
+
+void Event::setUpOutput(const std::string& full_name, EventObject& obj) {
+  std::lock_guard<std::mutex> lock{shared_->mutex};
+  auto& shared{shared_->objects.at(shared_->index.at(full_name))};
+  if (not shared.in_output) {
+    obj.data_->structure(*output_file_);
+    if (obj.should_load_) {
+      // the previous entries of this object may still be waiting to
+      // be copied into the output file and they need to go first
+      auto input_lock{lockInput()};
+      input_file_->finishCopies();
+    } else {
+      // this object did not exist for the entries already written
+      auto filler{shared.make(nullptr)};
+      filler->clear();
+      for (std::size_t i{0}; i < output_file_->events(); i++) filler->save(*output_file_);
+    }
+    shared.in_output = true;
+  }
+  obj.in_output_ = true;
+}
+
+bool Event::startCopying(const std::string& path) {
+  if (copying_.find(path) != copying_.end()) return false;
+  copying_.insert(path);
+  std::lock_guard<std::mutex> lock{shared_->mutex};
+  if (std::find(shared_->copies.begin(), shared_->copies.end(), path) != shared_->copies.end())
+    return false;
+  shared_->copies.push_back(path);
+  return true;
+}
+
+const std::vector<std::string>& Event::missingCopies() {
+  std::lock_guard<std::mutex> lock{shared_->mutex};
+  for (; copies_checked_ < shared_->copies.size(); copies_checked_++) {
+    const auto& path{shared_->copies[copies_checked_]};
+    // the copied paths are the full names within the event group
+    if (not available(path.substr(io::constants::EVENT_GROUP.size() + 1)))
+      missing_copies_.push_back(path);
+  }
+  return missing_copies_;
+}
+
+void Event::shareWith(const Event& other, std::mutex& input_mutex) {
+  shared_ = other.shared_;
+  input_mutex_ = &input_mutex;
+}
+
+void Event::sync() {
+  std::lock_guard<std::mutex> lock{shared_->mutex};
+  for (; synced_ < shared_->objects.size(); synced_++) {
+    const auto& shared{shared_->objects[synced_]};
+    std::string full_name{fullName(shared.tag.name(), shared.tag.pass())};
+    if (objectId(full_name) != NO_OBJECT) continue;
+
+    auto& obj{objects_[newObject(full_name)]};
+    {
+      auto input_lock{lockInput()};
+      obj.data_ = shared.make(shared.should_load ? input_file_ : nullptr);
+    }
+    obj.data_->clear();
+    obj.should_save_ = shared.tag.keep();
+    obj.should_load_ = shared.should_load;
+    obj.updated_ = false;
+    // read the current entry when needed
+    obj.behind_ = shared.should_load ? 1 : 0;
+
+    // the object is now in memory for us as well
+    const EventObjectTag* tag{available(full_name)};
+    if (not tag) tag = &makeAvailable(shared.tag);
+    tag->loaded_ = true;
+  }
 }
 
 void Event::setInputFile(io::Reader* r) {
@@ -92,23 +279,47 @@ void Event::setInputFile(io::Reader* r) {
   input_file_ = r;
 
   // there are input file, so mark the event header as should_load
-  objects_[EventHeader::NAME].should_load_ = true;
+  objects_[HEADER_ID].should_load_ = true;
+  // entries skipped in the previous file do not carry over
+  for (auto& obj : objects_) obj.behind_ = 0;
 
   // search through file and import the available objects that are there
   available_objects_.clear();
+  available_paths_.clear();
+  copy_started_.clear();
+  names_.clear();
+  full_names_.clear();
+  searches_.clear();
   known_lookups_.clear();
+  // the handles may refer to objects from a different pass now
+  handles_.clear();
+  copies_checked_ = 0;
+  missing_copies_.clear();
   for (const auto& [name, pass] : input_file_->availableObjects()) {
     std::string full_name{fullName(name, pass)};
     auto [ type, vers ] = input_file_->type(io::constants::EVENT_GROUP+"/"+full_name);
-    available_objects_.emplace_back(
-        name, pass, type, vers,
-        keep(full_name, READ_KEEP_DEFAULT));
+    auto& tag{makeAvailable({name, pass, type, vers,
+        keep(full_name, READ_KEEP_DEFAULT)})};
+    // objects loaded from a previous input file are still
+    // in memory and saved through it rather than copied
+    tag.loaded_ = objectId(full_name) != NO_OBJECT;
+  }
+}
+
+void Event::seek(std::size_t i_entry) {
+  assert(input_file_);
+  i_entry_ = i_entry;
+  auto input_lock{lockInput()};
+  for (auto& obj : objects_) {
+    obj.clear();
+    obj.behind_ = 0;
+    if (obj.should_load_) input_file_->seek_into(*obj.data_, i_entry_);
   }
 }
 
 void Event::next() {
   i_entry_++;
-  for (auto& [_, obj] : objects_) obj.clear();
+  for (auto& obj : objects_) obj.clear();
 }
 
 void Event::done() {
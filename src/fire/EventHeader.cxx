@@ -24,6 +24,10 @@ void Data<ldmx::EventHeader>::load(h5::Reader& r) {
   for (auto& m : members_) m->load(r);
 }
 
+void Data<ldmx::EventHeader>::seek(h5::Reader& r, std::size_t i_row) {
+  for (auto& m : members_) m->seek(r, i_row);
+}
+
 void Data<ldmx::EventHeader>::load(root::Reader& r) {
   // load ROOT stuff
   r.load(this->path_, *(this->handle_));
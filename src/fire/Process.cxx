@@ -1,30 +1,66 @@
 #include "fire/Process.h"
 #include "fire/io/Open.h"
+#include "fire/io/Trace.h"
 
+#include <algorithm>
+#include <iomanip>
 #include <iostream>
+#include <limits>
+#include <sstream>
 
 #include "fire/factory/Factory.h"
 
 namespace fire {
 
+namespace {
+
+/// does any of the names in the first list appear in the second?
+bool overlap(const std::vector<std::string>& a, const std::vector<std::string>& b) {
+  return std::find_first_of(a.begin(), a.end(), b.begin(), b.end()) != a.end();
+}
+
+/// must the later processor wait for the earlier one to finish?
+bool depends(const Processor& earlier, const Processor& later) {
+  if (not earlier.declaredObjects() or not later.declaredObjects()) return true;
+  return overlap(earlier.produced(), later.consumed())
+      or overlap(earlier.produced(), later.produced())
+      or overlap(earlier.consumed(), later.produced());
+}
+
+}  // namespace
+
+thread_local Process::EventSlot* Process::current_slot_{nullptr};
+
+Process::EventSlot::EventSlot(io::Writer* output_file,
+                              const config::Parameters& configuration)
+    : event{output_file,
+            configuration.get<std::string>("pass_name"),
+            configuration.get<std::vector<config::Parameters>>("drop_keep_rules", {}),
+            configuration.get<bool>("lazy_load", false)},
+      storage_control{configuration.get<config::Parameters>("storage")} {}
+
 Process::Process(const fire::config::Parameters& configuration)
-    : output_file_{configuration.get<int>("event_limit"),
-                   configuration.get<config::Parameters>("output_file")},
-      input_files_{
-          configuration.get<std::vector<std::string>>("input_files", {})},
-      event_{&output_file_,
-             configuration.get<std::string>("pass_name"),
-             configuration.get<std::vector<config::Parameters>>("drop_keep_rules", {})},
-      event_limit_{configuration.get<int>("event_limit")},
+    : event_limit_{configuration.get<int>("event_limit")},
+      first_entry_{configuration.get<int>("first_entry", 0)},
+      last_entry_{configuration.get<int>("last_entry", -1)},
       log_frequency_{configuration.get<int>("log_frequency")},
       max_tries_{configuration.get<int>("max_tries")},
       run_{configuration.get<int>("run")},
-      storage_control_{configuration.get<config::Parameters>("storage")},
+      input_files_{
+          configuration.get<std::vector<std::string>>("input_files", {})},
+      threads_{std::max(configuration.get<int>("threads", 1), 1)},
+      ordered_output_{configuration.get<bool>("ordered_output", true)},
+      pipeline_{configuration.get<bool>("pipeline", false)},
+      output_file_{configuration.get<int>("event_limit"),
+                   configuration.get<config::Parameters>("output_file")},
       run_header_{nullptr} {
   logging::open(logging::convertLevel(configuration.get<int>("term_level", 4)),
                 logging::convertLevel(configuration.get<int>("file_level", 4)),
                 configuration.get<std::string>("log_file", ""));
 
+  reader_parameters_.add("prefetch", configuration.get<bool>("prefetch", false));
+  reader_parameters_.add("memory_budget", configuration.get<int>("input_memory_budget", 0));
+
   // load the libraries of ConditionsProviders and Processors
   for (const auto& lib :
        configuration.get<std::vector<std::string>>("libraries", {}))
@@ -36,26 +72,157 @@ Process::Process(const fire::config::Parameters& configuration)
 
   auto sequence{
       configuration.get<std::vector<config::Parameters>>("sequence", {})};
-  if (sequence.empty() and not configuration.get<bool>("testing",false)) {
+  // merging the outputs of several workers only copies the input
+  if (sequence.empty() and not configuration.get<bool>("testing",false)
+      and not configuration.get<bool>("merge",false)) {
     throw Exception("Config",
         "No sequence has been defined. What should I be doing?\nUse "
         "p.sequence to tell me what processors to run.",false);
   }
-  for (const auto& proc : sequence) {
-    auto class_name{proc.get<std::string>("class_name")};
-    sequence_.emplace_back(Processor::Factory::get().make(class_name, proc, *this));
+
+  // one slot when serial, otherwise enough to keep the workers busy
+  // while we are saving finished events, when pipelined there is
+  // another two so one can be read while another is being saved
+  std::size_t num_slots{threads_ > 1 ? 2*std::size_t(threads_) : 1};
+  if (pipeline_) num_slots += 2;
+  for (std::size_t i_slot{0}; i_slot < num_slots; i_slot++) {
+    auto& slot{*slots_.emplace_back(std::make_unique<EventSlot>(&output_file_, configuration))};
+    if (num_slots > 1) {
+      slot.event.shareWith(slots_.front()->event, input_mutex_);
+      slot.storage_control.shareWith(slots_.front()->storage_control);
+    }
+    for (std::size_t i_proc{0}; i_proc < sequence.size(); i_proc++) {
+      if (i_slot > 0 and (threads_ == 1 or slots_.front()->sequence.at(i_proc)->threadSafe())) {
+        // share the first slot's processor, a single worker
+        // runs the processors on one event at a time
+        slot.sequence.push_back(slots_.front()->sequence.at(i_proc));
+        continue;
+      }
+      const auto& proc{sequence.at(i_proc)};
+      auto class_name{proc.get<std::string>("class_name")};
+      processors_.emplace_back(Processor::Factory::get().make(class_name, proc, *this));
+      slot.sequence.push_back(processors_.back().get());
+    }
+    free_slots_.push_back(&slot);
+  }
+  if (num_slots > 1) {
+    workers_ = std::make_unique<io::IOThread>(num_slots, threads_);
+  }
+  if (pipeline_) {
+    writer_ = std::make_unique<io::IOThread>(num_slots);
+  }
+
+  // the processors of each slot are in the same order, so we
+  // can use the first slot to find which ones depend on each other
+  int processor_threads{configuration.get<int>("processor_threads", 1)};
+  if (processor_threads > 1 and sequence.size() > 1) {
+    const auto& procs{slots_.front()->sequence};
+    dependents_.resize(procs.size());
+    num_dependencies_.assign(procs.size(), 0);
+    for (std::size_t later{0}; later < procs.size(); later++) {
+      for (std::size_t earlier{0}; earlier < later; earlier++) {
+        if (depends(*procs.at(earlier), *procs.at(later))) {
+          dependents_.at(earlier).push_back(later);
+          num_dependencies_.at(later)++;
+        }
+      }
+    }
+    tasks_ = std::make_unique<io::IOThread>(procs.size()*num_slots, processor_threads);
+    for (auto& slot : slots_) slot->event.processConcurrently();
+  }
+
+  // copies of a processor are timed together since they have the same name,
+  // the timer ids are all zero without timing so they can be given to Timing::Scope
+  bool counters{configuration.get<bool>("counters", false)};
+  if (configuration.get<bool>("timing", false) or counters)
+    timing_ = std::make_unique<Timing>(counters);
+  auto timer = [this](const std::string& name) -> std::size_t {
+    return timing_ ? timing_->add(name) : 0;
+  };
+  for (const auto& proc : slots_.front()->sequence)
+    process_timers_.push_back(timer(proc->getName() + "::process"));
+  for (const auto& proc : processors_) {
+    run_timers_.push_back(timer(proc->getName() + "::onNewRun"));
+    file_timers_.push_back(timer(proc->getName() + "::onFileOpen"));
+  }
+  load_timer_ = timer("Event::load");
+  save_timer_ = timer("Event::save");
+  // the output file times its own writes since they can happen on other threads
+  if (timing_) output_file_.time(*timing_);
+
+  auto trace_file{configuration.get<std::string>("trace_file", "")};
+  if (not trace_file.empty()) {
+    int trace_every{configuration.get<int>("trace_every", 1)};
+    if (trace_every < 1) {
+      throw Exception("Config", "Events can only be traced every " + std::to_string(trace_every)
+          + " events if it is at least one.", false);
+    }
+    io::Trace::open(trace_file, trace_every);
   }
 }
 
-Process::~Process() { logging::close(); }
+Process::~Process() {
+  // the workers may still be handing events to the writer
+  // and running processors on the task threads
+  workers_.reset();
+  writer_.reset();
+  tasks_.reset();
+  // the trace is written at the end of the run unless it failed
+  try {
+    io::Trace::close();
+  } catch (const Exception& e) {
+    std::cerr << "[" << e.category() << "] " << e.message() << std::endl;
+  }
+  logging::close();
+}
 
 void Process::run() {
+  if (first_entry_ < 0 or (last_entry_ >= 0 and last_entry_ < first_entry_)) {
+    throw Exception("Config", "The range of entries from " + std::to_string(first_entry_)
+        + " to " + std::to_string(last_entry_) + " is not valid.", false);
+  }
+
+  // each input file from start to finish
+  std::size_t i_file{0};
+  if (first_entry_ == 0 and last_entry_ < 0) {
+    run([this, i_file](EntryRange& range) mutable {
+      if (i_file == input_files_.size()) return false;
+      range = {i_file++, 0, std::numeric_limits<std::size_t>::max()};
+      return true;
+    });
+    return;
+  }
+
+  // only the window of entries, we count the entries in each file
+  // before opening it for processing so files before the window are skipped
+  std::size_t offset{0}, first{std::size_t(first_entry_)},
+      last{last_entry_ < 0 ? std::numeric_limits<std::size_t>::max()
+                           : std::size_t(last_entry_)};
+  config::Parameters counting;
+  counting.add("prefetch", false);
+  counting.add("memory_budget", 0);
+  run([&](EntryRange& range) {
+    while (i_file < input_files_.size() and offset < last) {
+      std::size_t entries{io::open(input_files_.at(i_file), counting)->entries()};
+      std::size_t i{i_file++};
+      offset += entries;
+      if (offset > first) {
+        range = {i, first > offset - entries ? first - (offset - entries) : 0,
+                 std::min(entries, last - (offset - entries))};
+        return true;
+      }
+    }
+    return false;
+  });
+}
+
+void Process::run(const RangeSource& next_range) {
   // counter for number of events we have processed
   std::size_t n_events_processed{0};
 
   // Start by notifying everyone that modules processing is beginning
   conditions_->onProcessStart();
-  for (auto& proc : sequence_) proc->onProcessStart();
+  for (auto& proc : processors_) proc->onProcessStart();
 
   // If we have no input files, but do have an event number, run for
   // that number of events and generate an output file.
@@ -67,15 +234,17 @@ void Process::run() {
     newRun(run_header);
 
     for (; n_events_processed < event_limit_; n_events_processed++) {
-      event_.header().setRun(run_);
-      event_.header().setEventNumber(n_events_processed + 1);
-      event_.header().setTimestamp();
+      EventSlot& slot{acquire()};
+      slot.n_processed = n_events_processed;
+      slot.event.header().setRun(run_);
+      slot.event.header().setEventNumber(n_events_processed + 1);
+      slot.event.header().setTimestamp();
 
       // keep trying to process this event until successful
       // or we hit the maximum number of tries
-      for (int num_tries{0}; num_tries < max_tries_; num_tries++)
-        if (process(n_events_processed)) break;
+      dispatch(slot, max_tries_);
     }
+    drain();
 
     runHeader().runEnd();
     fire_log(info) << runHeader();
@@ -97,43 +266,49 @@ void Process::run() {
     /// the cache of runs from the opened input files
     std::unordered_map<int, RunHeader> input_runs;
 
-    int ifile = 0;
     int wasRun = -1;
-    for (auto fn : input_files_) {
-      std::unique_ptr<io::Reader> input_file = io::open(fn);
-
-      /**
-       * Load runs into in-memory cache
-       */
-      try {
-        io::Data<RunHeader> read_d{RunHeader::NAME, input_file.get()};
-        std::size_t num_runs = input_file->runs();
-        for (std::size_t i_run{0}; i_run < num_runs; i_run++) {
-          input_file->load_into(read_d);
-          // deep copy
-          input_runs[read_d.get().getRunNumber()] = read_d.get();
-        }
-      } catch (const HighFive::Exception&) {
-        throw Exception("RunRead","Unable to extract runs from input file "+input_file->name());
+    std::unique_ptr<io::Reader> input_file;
+    std::size_t i_input_file{0}, next_entry{0};
+    EntryRange range;
+    while ((event_limit_ <= 0 or n_events_processed < std::size_t(event_limit_))
+           and next_range(range)) {
+      bool opened{not input_file or range.i_file != i_input_file};
+      if (opened) {
+        if (input_file) closeInput(*input_file);
+        input_file = openInput(range.i_file, input_runs);
+        i_input_file = range.i_file;
+        next_entry = 0;
+      }
+      if (range.first != next_entry and not input_file->canSeek()) {
+        throw Exception("Config", "Unable to jump to entry " + std::to_string(range.first)
+            + " of " + input_file->name() + " since it cannot seek.", false);
       }
 
-      fire_log(info) << "Opening " << input_file->name();
-
-      for (auto& module : sequence_) module->onFileOpen(input_file->name());
-      event_.setInputFile(input_file.get());
-
-      long unsigned int max_index = input_file->entries();
-      if (event_limit_ > 0 and max_index + n_events_processed > event_limit_)
-        max_index = event_limit_ - n_events_processed;
+      std::size_t max_index{std::min<std::size_t>(range.last, input_file->entries())};
+      if (event_limit_ > 0 and max_index > range.first + (event_limit_ - n_events_processed))
+        max_index = range.first + (event_limit_ - n_events_processed);
 
-      for (std::size_t i_entry_file{0}; i_entry_file < max_index;
+      for (std::size_t i_entry_file{range.first}; i_entry_file < max_index;
            i_entry_file++) {
+        EventSlot& slot{acquire()};
+        slot.n_processed = n_events_processed;
         // load data from input file into memory
-        event_.load();
+        //  the slots are filled out of order if there are several
+        //  and each range may start anywhere in the file
+        if (workers_ or (i_entry_file == range.first and (opened or range.first != next_entry)))
+          slot.event.seek(i_entry_file);
+        {
+          Timing::Scope load_scope{timing_.get(), load_timer_};
+          io::Trace::Span load_span{"Event::load", "event", io::Trace::sampled(slot.n_processed)};
+          slot.event.load();
+        }
 
         // notify for new run if necessary
-        if (event_.header().getRun() != wasRun) {
-          wasRun = event_.header().getRun();
+        if (slot.event.header().getRun() != wasRun) {
+          // the previous run is done before the new one starts
+          drain();
+          wasRun = slot.event.header().getRun();
+          current_slot_ = &slot;
           if (input_runs.find(wasRun) != input_runs.end()) {
             newRun(input_runs[wasRun]);
             fire_log(info) << "Got new run header from '" << input_file->name() << "\n"
@@ -142,23 +317,21 @@ void Process::run() {
             fire_log(warn) << "Run header for run " << wasRun
                            << " was not found!";
           }
+          current_slot_ = nullptr;
         }
 
-        process(n_events_processed);
+        dispatch(slot, 1);
 
         n_events_processed++;
       }  // loop through events
+      next_entry = max_index;
+    }  // loop through entry ranges
+    if (input_file) closeInput(*input_file);
 
-      fire_log(info) << "Closing " << input_file->name();
-
-      for (auto& proc : sequence_) proc->onFileClose(input_file->name());
-
-      if (event_limit_ > 0 && n_events_processed == event_limit_) {
-        fire_log(info) << "Reached event limit of " << event_limit_
-                       << " events";
-        break;
-      }
-    }  // loop through input files
+    if (event_limit_ > 0 && n_events_processed == event_limit_) {
+      fire_log(info) << "Reached event limit of " << event_limit_
+                     << " events";
+    }
 
     // copy the input run headers to the output file
     try {
@@ -175,10 +348,304 @@ void Process::run() {
   }  // are there input files? if-else tree
 
   // allow event bus to put final touches into the output file
-  event_.done();
+  {
+    io::Trace::Span flush_span{"Event::done", "io"};
+    slots_.front()->event.done();
+  }
+  fire_log(info) << "Peak buffer memory writing " << output_file_.name() << " : "
+                 << output_file_.peakBufferBytes() / 1e6 << " MB";
+
+  // report the storage hints given to all of the events
+  auto votes{slots_.front()->storage_control.votes()};
+  for (std::size_t i_slot{1}; i_slot < slots_.size(); i_slot++) {
+    auto slot_votes{slots_.at(i_slot)->storage_control.votes()};
+    for (std::size_t i{0}; i < slot_votes.size(); i++) {
+      votes.at(i).keep += slot_votes.at(i).keep;
+      votes.at(i).drop += slot_votes.at(i).drop;
+    }
+  }
+  for (const auto& v : votes) {
+    fire_log(info) << "Storage hints from " << v.processor
+                   << (v.purpose.empty() ? "" : " for " + v.purpose) << " : "
+                   << v.keep << " keep, " << v.drop << " drop"
+                   << (v.listened ? "" : " (not listened to)");
+  }
   // finally, notify everyone that we are stopping
-  for (auto& proc : sequence_) proc->onProcessEnd();
+  for (auto& proc : processors_) proc->onProcessEnd();
   conditions_->onProcessEnd();
+
+  if (timing_) reportTiming();
+  io::Trace::close();
+}
+
+void Process::reportTiming() {
+  auto summary{timing_->summary()};
+  std::size_t width{0};
+  for (const auto& row : summary) width = std::max(width, row.name.size());
+  std::stringstream table;
+  table << "Timing summary [s]\n" << std::left << std::setw(width) << "" << std::right
+        << std::setw(12) << "calls" << std::setw(12) << "wall" << std::setw(12) << "cpu"
+        << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(12) << "max";
+  for (const auto& row : summary) {
+    table << "\n" << std::left << std::setw(width) << row.name << std::right
+          << std::setw(12) << row.calls << std::setprecision(4)
+          << std::setw(12) << row.wall << std::setw(12) << row.cpu
+          << std::setw(12) << row.p50 << std::setw(12) << row.p99
+          << std::setw(12) << row.max;
+  }
+  fire_log(info) << table.str();
+
+  // the rates tell if a part is waiting on memory or doing computations
+  if (timing_->counters()) {
+    bool hardware{timing_->hardwareCounters()};
+    if (not hardware) {
+      fire_log(warn) << "Hardware performance counters are not available,"
+                     << " only page faults and context switches were counted.";
+    }
+    auto rate = [](long int n, long int d) { return d > 0 ? double(n)/d : 0.; };
+    std::stringstream counters;
+    counters << "Performance counters per call\n" << std::left << std::setw(width) << ""
+             << std::right;
+    if (hardware) {
+      counters << std::setw(12) << "IPC" << std::setw(12) << "cache/kI"
+               << std::setw(12) << "branch/kI";
+    }
+    counters << std::setw(12) << "faults" << std::setw(12) << "switches";
+    for (const auto& row : summary) {
+      counters << "\n" << std::left << std::setw(width) << row.name << std::right
+               << std::setprecision(4);
+      if (hardware) {
+        counters << std::setw(12) << rate(row.counts[Timing::INSTRUCTIONS],
+                                          row.counts[Timing::CYCLES])
+                 << std::setw(12) << 1000*rate(row.counts[Timing::CACHE_MISSES],
+                                               row.counts[Timing::INSTRUCTIONS])
+                 << std::setw(12) << 1000*rate(row.counts[Timing::BRANCH_MISSES],
+                                               row.counts[Timing::INSTRUCTIONS]);
+      }
+      counters << std::setw(12) << rate(row.counts[Timing::PAGE_FAULTS], row.calls)
+               << std::setw(12) << rate(row.counts[Timing::CONTEXT_SWITCHES], row.calls);
+    }
+    fire_log(info) << counters.str();
+  }
+
+  // the output file flushes anything left when it is closed
+  try {
+    io::Data<Timing::Summary> write_d{Timing::NAME};
+    write_d.structure(output_file_);
+    for (const auto& row : summary) {
+      write_d.update(row);
+      write_d.save(output_file_);
+    }
+  } catch (const HighFive::Exception&) {
+    throw Exception("TimingWrite", "Unable to write timing summary to output file "
+        + output_file_.name());
+  }
+}
+
+std::unique_ptr<io::Reader> Process::openInput(std::size_t i_file,
+    std::unordered_map<int, RunHeader>& input_runs) {
+  io::Trace::Span span{"Process::openInput", "io", true, input_files_.at(i_file)};
+  std::unique_ptr<io::Reader> input_file = io::open(input_files_.at(i_file), reader_parameters_);
+
+  /**
+   * Load runs into in-memory cache
+   */
+  try {
+    io::Data<RunHeader> read_d{RunHeader::NAME, input_file.get()};
+    std::size_t num_runs = input_file->runs();
+    for (std::size_t i_run{0}; i_run < num_runs; i_run++) {
+      input_file->load_into(read_d);
+      // deep copy
+      input_runs[read_d.get().getRunNumber()] = read_d.get();
+    }
+  } catch (const HighFive::Exception&) {
+    throw Exception("RunRead","Unable to extract runs from input file "+input_file->name());
+  }
+
+  fire_log(info) << "Opening " << input_file->name();
+
+  if (workers_ and not input_file->canSeek()) {
+    throw Exception("Config", "Unable to process " + input_file->name() 
+        + " with more than one event in flight since it cannot seek.", false);
+  }
+
+  for (std::size_t i_proc{0}; i_proc < processors_.size(); i_proc++) {
+    Timing::Scope file_scope{timing_.get(), file_timers_.at(i_proc)};
+    processors_.at(i_proc)->onFileOpen(input_file->name());
+  }
+  for (auto& slot : slots_) slot->event.setInputFile(input_file.get());
+  return input_file;
+}
+
+void Process::closeInput(io::Reader& input_file) {
+  io::Trace::Span span{"Process::closeInput", "io", true, input_file.name()};
+  drain();
+
+  // copy the kept objects that were not accessed
+  input_file.finishCopies();
+
+  fire_log(info) << "Closing " << input_file.name();
+  if (reader_parameters_.get<bool>("prefetch")) {
+    fire_log(info) << "Waited " << input_file.prefetchStallTime()
+                   << "s for prefetched data from " << input_file.name();
+  }
+  fire_log(info) << "Peak buffer memory reading " << input_file.name() << " : "
+                 << input_file.peakBufferBytes() / 1e6 << " MB";
+
+  for (auto& proc : processors_) proc->onFileClose(input_file.name());
+}
+
+Process::EventSlot& Process::acquire() {
+  EventSlot* slot{nullptr};
+  if (writer_) {
+    // the writer thread gives slots back, so take one while holding the lock
+    std::unique_lock<std::mutex> lock{slot_mutex_};
+    slot_free_.wait(lock, [this]() {
+      return pipeline_error_ or not free_slots_.empty();
+    });
+    if (pipeline_error_) {
+      auto e{pipeline_error_};
+      pipeline_error_ = nullptr;
+      std::rethrow_exception(e);
+    }
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  } else {
+    if (free_slots_.empty()) retire();
+    slot = free_slots_.back();
+    free_slots_.pop_back();
+  }
+  slot->event.sync();
+  return *slot;
+}
+
+void Process::dispatch(EventSlot& slot, int max_tries) {
+  // status statement printed to log
+  std::size_t n{slot.n_processed};
+  if ((log_frequency_ != -1) && ((n + 1) % log_frequency_ == 0)) {
+    std::time_t time = std::time(nullptr);
+    fire_log(info) << "Processing " << n + 1 << " Run "
+                   << slot.event.header().getRun() << " Event "
+                   << slot.event.header().getEventNumber() << " : "
+                   << std::asctime(std::localtime(&time));
+  }
+
+  auto job = [this, &slot, max_tries]() {
+    current_slot_ = &slot;
+    slot.processed = false;
+    try {
+      for (int num_tries{0}; num_tries < max_tries; num_tries++)
+        if ((slot.processed = process(slot))) break;
+    } catch (...) {
+      slot.error = std::current_exception();
+    }
+    current_slot_ = nullptr;
+  };
+
+  if (not workers_) {
+    job();
+    free_slots_.push_back(&slot);
+    finish(slot);
+    return;
+  }
+
+  slot.done = false;
+  if (writer_) {
+    std::lock_guard<std::mutex> lock{slot_mutex_};
+    in_pipeline_++;
+  } else {
+    in_flight_.push_back(&slot);
+  }
+  // the writer starts its jobs in order, so ordered output
+  // only needs the save to be queued when the event is dispatched
+  bool store_in_order{writer_ and ordered_output_};
+  if (store_in_order) writer_->submit([this, &slot]() { store(slot); });
+  workers_->submit([this, &slot, job, store_in_order]() {
+    job();
+    {
+      std::lock_guard<std::mutex> lock{slot_mutex_};
+      slot.done = true;
+    }
+    slot_done_.notify_all();
+    if (writer_ and not store_in_order)
+      writer_->submit([this, &slot]() { store(slot); });
+  });
+}
+
+void Process::retire() {
+  std::deque<EventSlot*>::iterator it;
+  {
+    std::unique_lock<std::mutex> lock{slot_mutex_};
+    slot_done_.wait(lock, [&]() {
+      if (ordered_output_) {
+        it = in_flight_.begin();
+      } else {
+        it = std::find_if(in_flight_.begin(), in_flight_.end(),
+                          [](EventSlot* s) { return s->done; });
+      }
+      return it != in_flight_.end() and (*it)->done;
+    });
+  }
+  EventSlot& slot{**it};
+  in_flight_.erase(it);
+  // make the slot available again even if there was an error
+  free_slots_.push_back(&slot);
+  finish(slot);
+}
+
+void Process::drain() {
+  if (not writer_) {
+    while (not in_flight_.empty()) retire();
+    return;
+  }
+  std::unique_lock<std::mutex> lock{slot_mutex_};
+  slot_free_.wait(lock, [this]() {
+    return pipeline_error_ or in_pipeline_ == 0;
+  });
+  if (pipeline_error_) {
+    auto e{pipeline_error_};
+    pipeline_error_ = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+void Process::store(EventSlot& slot) {
+  {
+    std::unique_lock<std::mutex> lock{slot_mutex_};
+    slot_done_.wait(lock, [&slot]() { return slot.done; });
+  }
+  std::exception_ptr error;
+  try {
+    finish(slot);
+  } catch (...) {
+    error = std::current_exception();
+  }
+  {
+    // make the slot available again even if there was an error
+    std::lock_guard<std::mutex> lock{slot_mutex_};
+    if (error and not pipeline_error_) pipeline_error_ = error;
+    free_slots_.push_back(&slot);
+    in_pipeline_--;
+  }
+  slot_free_.notify_all();
+}
+
+void Process::finish(EventSlot& slot) {
+  if (slot.error) {
+    auto e{slot.error};
+    slot.error = nullptr;
+    std::rethrow_exception(e);
+  }
+
+  // we didn't abort the event, so we should give the option to save it
+  if (slot.processed and slot.storage_control.keepEvent()) {
+    Timing::Scope save_scope{timing_.get(), save_timer_};
+    io::Trace::Span save_span{"Event::save", "event", io::Trace::sampled(slot.n_processed)};
+    slot.event.save();
+  }
+
+  // move to the next event
+  slot.event.next();
 }
 
 void Process::newRun(RunHeader& rh) {
@@ -187,42 +654,105 @@ void Process::newRun(RunHeader& rh) {
   run_header_ = &rh;
   // Processors are allowed to put parameters into
   // the run header through 'beforeNewRun' method
-  for (auto& proc : sequence_) proc->beforeNewRun(rh);
+  for (auto& proc : processors_) proc->beforeNewRun(rh);
   // now run header has been modified by Processors,
   // it is valid to read from for everyone else in 'onNewRun'
   conditions_->onNewRun(rh);
-  for (auto& proc : sequence_) proc->onNewRun(rh);
-}
-
-bool Process::process(const std::size_t& n) {
-  // status statement printed to log
-  if ((log_frequency_ != -1) && ((n + 1) % log_frequency_ == 0)) {
-    std::time_t time = std::time(nullptr);
-    fire_log(info) << "Processing " << n + 1 << " Run "
-                   << event_.header().getRun() << " Event "
-                   << event_.header().getEventNumber() << " : "
-                   << std::asctime(std::localtime(&time));
+  for (std::size_t i_proc{0}; i_proc < processors_.size(); i_proc++) {
+    Timing::Scope run_scope{timing_.get(), run_timers_.at(i_proc)};
+    processors_.at(i_proc)->onNewRun(rh);
   }
+}
 
+bool Process::process(EventSlot& slot) {
   // new event processing, forget old information
-  storage_control_.resetEventState();
+  slot.storage_control.resetEventState();
 
+  bool traced{io::Trace::sampled(slot.n_processed)};
+  io::Trace::Span event_span{"event", "event", traced,
+                             traced ? std::to_string(slot.n_processed) : std::string()};
   try {
-    // go through each processor in the sequence in order
-    for (auto& proc : sequence_) proc->process(event_);
+    if (tasks_) {
+      runConcurrently(slot);
+    } else {
+      // go through each processor in the sequence in order
+      for (std::size_t i_proc{0}; i_proc < slot.sequence.size(); i_proc++) {
+        Timing::Scope process_scope{timing_.get(), process_timers_[i_proc]};
+        io::Trace::Span process_span{slot.sequence[i_proc]->getName(), "processor", traced};
+        slot.sequence[i_proc]->process(slot.event);
+      }
+    }
   } catch (Processor::AbortEventException&) {
     return false;
   }
 
-  // we didn't abort the event, so we should give the option to save it
-  if (storage_control_.keepEvent()) {
-    event_.save();
-  }
+  return true;
+}
 
-  // move to the next event
-  event_.next();
+void Process::runConcurrently(EventSlot& slot) {
+  std::vector<std::size_t> waiting{num_dependencies_};
+  std::vector<std::exception_ptr> errors(slot.sequence.size());
+  bool traced{io::Trace::sampled(slot.n_processed)};
+  auto run = [this, &slot, &errors, traced](std::size_t i_proc) {
+    current_slot_ = &slot;
+    try {
+      Timing::Scope process_scope{timing_.get(), process_timers_[i_proc]};
+      io::Trace::Span process_span{slot.sequence.at(i_proc)->getName(), "processor", traced};
+      slot.sequence.at(i_proc)->process(slot.event);
+    } catch (...) {
+      errors[i_proc] = std::current_exception();
+    }
+  };
+
+  std::vector<std::size_t> ready, finished;
+  for (std::size_t i_proc{0}; i_proc < waiting.size(); i_proc++)
+    if (waiting.at(i_proc) == 0) ready.push_back(i_proc);
+  std::size_t running{0};
+  bool failed{false};
+  std::mutex mutex;
+  std::condition_variable finished_cv;
+  std::unique_lock<std::mutex> lock{mutex};
+  while (true) {
+    for (std::size_t i_proc : finished) {
+      if (errors.at(i_proc)) failed = true;
+      for (std::size_t later : dependents_.at(i_proc))
+        if (--waiting.at(later) == 0) ready.push_back(later);
+    }
+    finished.clear();
+    if (failed) ready.clear();
 
-  return true;
+    if (ready.empty()) {
+      if (running == 0) break;
+      finished_cv.wait(lock, [&finished]() { return not finished.empty(); });
+      continue;
+    }
+
+    std::size_t ours{ready.back()};
+    ready.pop_back();
+    std::vector<std::size_t> theirs;
+    theirs.swap(ready);
+    running += theirs.size();
+    lock.unlock();
+    for (std::size_t i_proc : theirs) {
+      tasks_->submit([&, i_proc]() {
+        run(i_proc);
+        // the task thread goes on to other events
+        current_slot_ = nullptr;
+        // notify while holding the lock, we may return as soon as it is released
+        std::lock_guard<std::mutex> task_lock{mutex};
+        finished.push_back(i_proc);
+        running--;
+        finished_cv.notify_one();
+      });
+    }
+    run(ours);
+    lock.lock();
+    finished.push_back(ours);
+  }
+
+  // the earliest processor's exception is what running in order would throw
+  for (const auto& error : errors)
+    if (error) std::rethrow_exception(error);
 }
 
 }  // namespace fire
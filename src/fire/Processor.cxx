@@ -6,7 +6,10 @@ namespace fire {
 
 Processor::Processor(const config::Parameters& ps)
     : theLog_{logging::makeLogger(ps.get<std::string>("name"))},
-      name_{ps.get<std::string>("name")} {}
+      name_{ps.get<std::string>("name")},
+      consumed_{ps.get<std::vector<std::string>>("consumes", {})},
+      produced_{ps.get<std::vector<std::string>>("produces", {})},
+      declared_objects_{ps.exists("consumes") or ps.exists("produces")} {}
 
 void Processor::setStorageHint(StorageControl::Hint hint,
                                const std::string& purpose) const {
@@ -14,6 +17,17 @@ void Processor::setStorageHint(StorageControl::Hint hint,
   process_->addStorageControlHint(hint, purpose, name_);
 }
 
+void Processor::setStorageHint(StorageControl::Hint hint,
+                               const StorageControl::HintToken& token) const {
+  assert(process_);
+  process_->addStorageControlHint(hint, token);
+}
+
+StorageControl::HintToken Processor::storageHintToken(const std::string& purpose) const {
+  assert(process_);
+  return process_->storageControlToken(purpose, name_);
+}
+
 Conditions &Processor::getConditions() const {
   assert(process_);
   return process_->conditions();
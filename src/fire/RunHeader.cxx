@@ -43,6 +43,10 @@ void Data<ldmx::RunHeader>::load(h5::Reader& r) {
   for (auto& m : members_) m->load(r);
 }
 
+void Data<ldmx::RunHeader>::seek(h5::Reader& r, std::size_t i_row) {
+  for (auto& m : members_) m->seek(r, i_row);
+}
+
 void Data<ldmx::RunHeader>::load(root::Reader& r) {
   // load ROOT stuff
   r.load(this->path_, *(this->handle_));
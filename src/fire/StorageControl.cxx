@@ -1,9 +1,12 @@
 #include "fire/StorageControl.h"
 
+#include <algorithm>
+
 namespace fire {
 
 StorageControl::StorageControl(const config::Parameters& ps)
-    : default_keep_{ps.get<bool>("default_keep")} {
+    : default_keep_{ps.get<bool>("default_keep")},
+      hinters_{std::make_shared<Hinters>()} {
   auto listening_rules{ps.get<std::vector<config::Parameters>>("listening_rules",{})};
   for (const auto& listening_rule : listening_rules) {
     auto proc_regex_str = listening_rule.get<std::string>("processor");
@@ -33,19 +36,71 @@ StorageControl::StorageControl(const config::Parameters& ps)
 
 void StorageControl::resetEventState() { hints_.clear(); }
 
+void StorageControl::shareWith(const StorageControl& other) {
+  hinters_ = other.hinters_;
+}
+
+StorageControl::HintToken StorageControl::token(const std::string& purpose,
+                                                const std::string& processor_name) {
+  std::string key{processor_name + '\0' + purpose};
+  std::lock_guard<std::mutex> lock{hinters_->mutex};
+  auto known{hinters_->index.find(key)};
+  if (known != hinters_->index.end()) {
+    return {known->second, hinters_->hinters[known->second].listened};
+  }
+
+  // only count hints if the processor and purpose
+  // provided match one of the rules
+  bool listened{std::any_of(rules_.begin(), rules_.end(),
+      [&](const auto& rule) {
+        return std::regex_match(processor_name, rule.first) and
+               std::regex_match(purpose, rule.second);
+      })};
+  std::size_t index{hinters_->hinters.size()};
+  hinters_->hinters.push_back({processor_name, purpose, listened});
+  hinters_->index[key] = index;
+  return {index, listened};
+}
+
 void StorageControl::addHint(Hint hint, const std::string& purpose,
                               const std::string& processor_name) {
-  for (const auto& [proc_rule, purp_rule] : rules_) {
-    // only count this hint if the processor and purpose
-    // provided match the rule
-    if (std::regex_match(processor_name, proc_rule) and
-        std::regex_match(purpose, purp_rule)) {
-      // store hint for later tallying
-      hints_.push_back(hint);
-      // leave after first rule match to avoid double-counting
-      break;
-    }
+  std::string key{processor_name + '\0' + purpose};
+  std::unique_lock<std::mutex> lock{hints_mutex_};
+  auto known{tokens_.find(key)};
+  if (known == tokens_.end()) {
+    lock.unlock();
+    HintToken t{token(purpose, processor_name)};
+    lock.lock();
+    known = tokens_.emplace(key, t).first;
+  }
+  HintToken t{known->second};
+  lock.unlock();
+  addHint(hint, t);
+}
+
+void StorageControl::addHint(Hint hint, const HintToken& token) {
+  std::lock_guard<std::mutex> lock{hints_mutex_};
+  if (token.index >= counts_.size()) counts_.resize(token.index + 1);
+  if (hint == Hint::ShouldKeep || hint == Hint::MustKeep)
+    counts_[token.index].first++;
+  else if (hint == Hint::ShouldDrop || hint == Hint::MustDrop)
+    counts_[token.index].second++;
+  // store hint for later tallying
+  if (token.listened) hints_.push_back(hint);
+}
+
+std::vector<StorageControl::Votes> StorageControl::votes() const {
+  std::vector<Votes> votes;
+  {
+    std::lock_guard<std::mutex> lock{hinters_->mutex};
+    votes = hinters_->hinters;
+  }
+  std::lock_guard<std::mutex> lock{hints_mutex_};
+  for (std::size_t i{0}; i < counts_.size() and i < votes.size(); i++) {
+    votes[i].keep = counts_[i].first;
+    votes[i].drop = counts_[i].second;
   }
+  return votes;
 }
 
 bool StorageControl::keepEvent() const {
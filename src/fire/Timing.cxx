@@ -0,0 +1,196 @@
+#include "fire/Timing.h"
+
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace fire {
+
+namespace {
+
+/**
+ * The hardware counters of a thread
+ *
+ * The counters are opened as a group so that they are all scheduled
+ * onto the hardware together and then read at once. The leader is
+ * pinned so that the group is never multiplexed with other counters,
+ * if the hardware cannot hold it the group fails to read instead
+ * of giving counts that are only a fraction of the calls.
+ */
+class HardwareCounters {
+ public:
+  /// open the counters of the calling thread, none are left open on failure
+  HardwareCounters() {
+    static const std::uint64_t configs[] = {PERF_COUNT_HW_CPU_CYCLES,
+      PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+    for (auto config : configs) {
+      perf_event_attr attr{};
+      attr.size = sizeof(attr);
+      attr.type = PERF_TYPE_HARDWARE;
+      attr.config = config;
+      attr.read_format = PERF_FORMAT_GROUP;
+      attr.pinned = fds_.empty();
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+      int fd = syscall(SYS_perf_event_open, &attr, 0, -1, fds_.empty() ? -1 : fds_.front(), 0);
+      if (fd < 0) {
+        close();
+        return;
+      }
+      fds_.push_back(fd);
+    }
+  }
+
+  /// close the counters when the thread exits
+  ~HardwareCounters() { close(); }
+
+  /**
+   * Read the counters
+   * @param[out] counts counters to put the hardware counts into
+   * @return true if the counters were read
+   */
+  bool read(Timing::Counts& counts) const {
+    if (fds_.empty()) return false;
+    struct {
+      std::uint64_t nr;
+      std::uint64_t values[Timing::PAGE_FAULTS];
+    } group;
+    if (::read(fds_.front(), &group, sizeof(group)) != sizeof(group)) return false;
+    std::copy(group.values, group.values + Timing::PAGE_FAULTS, counts.begin());
+    return true;
+  }
+
+ private:
+  /// close any open counters
+  void close() {
+    for (int fd : fds_) ::close(fd);
+    fds_.clear();
+  }
+
+  /// file descriptors of the counters, the leader first
+  std::vector<int> fds_;
+};
+
+}  // namespace
+
+Timing::Scope::Scope(Timing* timing, std::size_t id)
+    : timing_{timing}, id_{id} {
+  if (not timing_) return;
+  // the counters are read outside of the times so they do not add to them
+  if (timing_->counters_ and not threadCounts(counts_start_)) timing_->hardware_ = false;
+  wall_start_ = std::chrono::steady_clock::now();
+  cpu_start_ = threadCPUTime();
+}
+
+Timing::Scope::~Scope() {
+  if (not timing_) return;
+  auto wall{std::chrono::duration_cast<std::chrono::nanoseconds>(
+      std::chrono::steady_clock::now() - wall_start_).count()};
+  std::uint64_t cpu{threadCPUTime() - cpu_start_};
+  if (not timing_->counters_) {
+    timing_->record(id_, wall, cpu);
+    return;
+  }
+  Counts counts;
+  if (not threadCounts(counts)) timing_->hardware_ = false;
+  for (std::size_t i{0}; i < NUM_COUNTERS; i++) counts[i] -= counts_start_[i];
+  timing_->record(id_, wall, cpu, &counts);
+}
+
+std::size_t Timing::add(const std::string& name) {
+  auto known{ids_.find(name)};
+  if (known != ids_.end()) return known->second;
+  std::size_t id{timers_.size()};
+  timers_.emplace_back().name = name;
+  ids_[name] = id;
+  return id;
+}
+
+void Timing::record(std::size_t id, std::uint64_t wall_ns, std::uint64_t cpu_ns,
+                    const Counts* counts) {
+  auto& timer{timers_[id]};
+  if (counts) {
+    for (std::size_t i{0}; i < NUM_COUNTERS; i++)
+      timer.counts[i].fetch_add((*counts)[i], std::memory_order_relaxed);
+  }
+  timer.calls.fetch_add(1, std::memory_order_relaxed);
+  timer.wall.fetch_add(wall_ns, std::memory_order_relaxed);
+  timer.cpu.fetch_add(cpu_ns, std::memory_order_relaxed);
+  timer.buckets[bucket(wall_ns)].fetch_add(1, std::memory_order_relaxed);
+  std::uint64_t max{timer.max.load(std::memory_order_relaxed)};
+  while (wall_ns > max and not timer.max.compare_exchange_weak(max, wall_ns,
+                                                                std::memory_order_relaxed)) {}
+}
+
+std::vector<Timing::Summary> Timing::summary() const {
+  static const double NS{1e-9};
+  std::vector<Summary> rows;
+  for (const auto& timer : timers_) {
+    auto& row{rows.emplace_back()};
+    row.name = timer.name;
+    std::uint64_t calls{timer.calls.load()}, max{timer.max.load()};
+    row.calls = calls;
+    row.wall = timer.wall.load()*NS;
+    row.cpu = timer.cpu.load()*NS;
+    row.max = max*NS;
+    row.p50 = row.p99 = 0.;
+    row.counts.fill(-1);
+    if (counters_) {
+      std::size_t first{hardwareCounters() ? 0 : std::size_t(PAGE_FAULTS)};
+      for (std::size_t i{first}; i < NUM_COUNTERS; i++) row.counts[i] = timer.counts[i].load();
+    }
+    if (calls == 0) continue;
+
+    // the percentiles are the upper edges of the buckets they are in,
+    // but they cannot be longer than the longest call
+    auto percentile = [&](double p) {
+      std::uint64_t rank{std::max<std::uint64_t>(1, std::uint64_t(p*calls + 0.5))}, below{0};
+      for (std::size_t i{0}; i < NUM_BUCKETS; i++) {
+        below += timer.buckets[i].load();
+        if (below >= rank) return std::min(upperEdge(i), max)*NS;
+      }
+      return max*NS;
+    };
+    row.p50 = percentile(0.50);
+    row.p99 = percentile(0.99);
+  }
+  return rows;
+}
+
+std::uint64_t Timing::threadCPUTime() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return std::uint64_t(ts.tv_sec)*1000000000ul + ts.tv_nsec;
+}
+
+bool Timing::threadCounts(Counts& counts) {
+  thread_local HardwareCounters hardware;
+  counts.fill(0);
+  bool read{hardware.read(counts)};
+  rusage usage;
+  getrusage(RUSAGE_THREAD, &usage);
+  counts[PAGE_FAULTS] = usage.ru_minflt + usage.ru_majflt;
+  counts[CONTEXT_SWITCHES] = usage.ru_nvcsw + usage.ru_nivcsw;
+  return read;
+}
+
+std::size_t Timing::bucket(std::uint64_t ns) {
+  // the first four buckets are one nanosecond wide, then each power
+  // of two is split into four by the two bits after the leading one
+  if (ns < 4) return ns;
+  int msb{63 - __builtin_clzll(ns)};
+  return 4*(msb - 1) + ((ns >> (msb - 2)) & 3);
+}
+
+std::uint64_t Timing::upperEdge(std::size_t i_bucket) {
+  if (i_bucket < 4) return i_bucket + 1;
+  std::size_t msb{i_bucket/4 + 1}, quarter{i_bucket % 4};
+  return (4 + quarter + 1) << (msb - 2);
+}
+
+}  // namespace fire
@@ -31,7 +31,16 @@ void UserReader::open(const std::string& fn, unsigned long int n) {
   in_file_ = false;
   reader_ = io::open(fn);
   event_.setInputFile(reader_.get());
-  for (int i{0}; i < n; i++) next();
+  if (n == 0 or n > reader_->entries()) {
+    // going passed the end of the file is left to next to wrap around
+    for (unsigned long int i{0}; i < n; i++) next();
+    return;
+  }
+  // jump straight to the n'th entry rather than loading the ones before it
+  event_.seek(n-1);
+  event_.load();
+  i_entry_ = n;
+  in_file_ = true;
 }
 
 bool UserReader::next() {
@@ -0,0 +1,225 @@
+#include "fire/Workers.h"
+
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <filesystem>
+#include <iostream>
+#include <new>
+
+#include "fire/Process.h"
+#include "fire/io/Open.h"
+
+namespace fire {
+
+namespace {
+
+/// number of ranges to split the entries into for each worker
+static const std::size_t RANGES_PER_WORKER{8};
+
+/**
+ * Get the name of a worker's partial file next to the full file
+ *
+ * @param[in] name name of full file
+ * @param[in] i_worker index of worker
+ * @return name of partial file for the worker
+ */
+std::string partialName(const std::string& name, int i_worker) {
+  std::filesystem::path path{name};
+  return (path.parent_path() / (path.stem().string() + "_worker"
+        + std::to_string(i_worker) + path.extension().string())).string();
+}
+
+/**
+ * Run the processing in a forked worker
+ *
+ * The worker writes into its own partial output file and takes
+ * ranges from the work queue until it is empty. Each range the worker
+ * took is counted so that we know which partial outputs have events.
+ *
+ * @param[in] configuration complete processing configuration
+ * @param[in] i_worker index of this worker
+ * @param[in] ranges ranges of entries in the work queue
+ * @param[in,out] queue index of the next range followed by the count of each worker
+ * @return exit status of the worker
+ */
+int work(const config::Parameters& configuration, int i_worker,
+         const std::vector<Process::EntryRange>& ranges,
+         std::atomic<std::size_t>* queue) {
+  try {
+    config::Parameters worker_config{configuration};
+    auto output_file{configuration.get<config::Parameters>("output_file")};
+    output_file.set("name", partialName(output_file.get<std::string>("name"), i_worker));
+    worker_config.set("output_file", output_file);
+    worker_config.set("event_limit", -1);
+    auto log_file{configuration.get<std::string>("log_file", "")};
+    if (not log_file.empty()) worker_config.set("log_file", partialName(log_file, i_worker));
+    auto trace_file{configuration.get<std::string>("trace_file", "")};
+    if (not trace_file.empty())
+      worker_config.set("trace_file", partialName(trace_file, i_worker));
+
+    Process p{worker_config};
+    p.run([&](Process::EntryRange& range) {
+      std::size_t i_range{queue[0]++};
+      if (i_range >= ranges.size()) return false;
+      queue[1 + i_worker]++;
+      range = ranges.at(i_range);
+      return true;
+    });
+  } catch (const Exception& e) {
+    std::cerr << "[" << e.category() << "] " << e.message() << std::endl;
+    return 2;
+  } catch (const std::exception& e) {
+    std::cerr << "UNKNOWN EXCEPTION: " << e.what() << std::endl;
+    return 127;
+  }
+  std::cout.flush();
+  return 0;
+}
+
+}  // namespace
+
+void runWorkers(const config::Parameters& configuration, int num_workers) {
+  auto input_files{configuration.get<std::vector<std::string>>("input_files", {})};
+  if (input_files.empty()) {
+    throw Exception("Config",
+        "Several workers split the input files, but there are none.", false);
+  }
+
+  // count the entries to process in each file, the files are closed
+  // again before forking so the workers do not share them
+  int event_limit{configuration.get<int>("event_limit")};
+  long first_entry{configuration.get<int>("first_entry", 0)},
+      last_entry{configuration.get<int>("last_entry", -1)};
+  if (first_entry < 0 or (last_entry >= 0 and last_entry < first_entry)) {
+    throw Exception("Config", "The range of entries from " + std::to_string(first_entry)
+        + " to " + std::to_string(last_entry) + " is not valid.", false);
+  }
+  std::vector<std::size_t> firsts, entries;
+  std::size_t total{0}, offset{0};
+  config::Parameters reader_parameters;
+  reader_parameters.add("prefetch", false);
+  reader_parameters.add("memory_budget", 0);
+  for (const auto& fn : input_files) {
+    auto input_file{io::open(fn, reader_parameters)};
+    if (not input_file->canSeek()) {
+      throw Exception("Config", "Unable to split " + input_file->name()
+          + " among workers since it cannot seek.", false);
+    }
+    // the window of entries is counted across all of the files
+    std::size_t first{0}, n{input_file->entries()};
+    if (std::size_t(first_entry) > offset) first = std::min(n, first_entry - offset);
+    if (last_entry >= 0) n = std::min(n, std::max<std::size_t>(last_entry, offset) - offset);
+    offset += input_file->entries();
+    n = std::max(n, first);
+    if (event_limit > 0) n = std::min(n, first + (event_limit - total));
+    firsts.push_back(first);
+    entries.push_back(n);
+    total += n - first;
+  }
+
+  num_workers = std::max(1, num_workers);
+  std::vector<Process::EntryRange> ranges;
+  std::size_t range_size{std::max<std::size_t>(1, total / (RANGES_PER_WORKER*num_workers))};
+  for (std::size_t i_file{0}; i_file < entries.size(); i_file++) {
+    for (std::size_t first{firsts.at(i_file)}; first < entries.at(i_file); first += range_size)
+      ranges.push_back({i_file, first, std::min(first + range_size, entries.at(i_file))});
+  }
+  if (ranges.empty()) {
+    // nothing to split, the output only needs the run headers
+    Process p{configuration};
+    p.run();
+    return;
+  }
+  num_workers = std::min(num_workers, int(ranges.size()));
+
+  // the work queue is shared with the workers through an anonymous mapping
+  std::size_t queue_bytes{(1 + num_workers)*sizeof(std::atomic<std::size_t>)};
+  void* mapping{mmap(nullptr, queue_bytes, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0)};
+  if (mapping == MAP_FAILED) {
+    throw Exception("Workers", "Unable to map the work queue into shared memory.", false);
+  }
+  auto queue{static_cast<std::atomic<std::size_t>*>(mapping)};
+  for (int i{0}; i < 1 + num_workers; i++) new (queue + i) std::atomic<std::size_t>{0};
+
+  // anything still buffered would be printed by each worker as well
+  std::cout.flush();
+  std::vector<pid_t> pids;
+  for (int i_worker{0}; i_worker < num_workers; i_worker++) {
+    pid_t pid{fork()};
+    if (pid < 0) {
+      // the workers already started would take all of the ranges into
+      // partial outputs that are never merged, so stop them
+      for (pid_t started : pids) kill(started, SIGKILL);
+      for (pid_t started : pids) waitpid(started, nullptr, 0);
+      munmap(mapping, queue_bytes);
+      throw Exception("Workers", "Unable to fork worker " + std::to_string(i_worker), false);
+    } else if (pid == 0) {
+      // skip the clean up of the state copied from the coordinator
+      _exit(work(configuration, i_worker, ranges, queue));
+    }
+    pids.push_back(pid);
+  }
+
+  std::string failed;
+  for (int i_worker{0}; i_worker < num_workers; i_worker++) {
+    int status{0};
+    if (waitpid(pids.at(i_worker), &status, 0) < 0 or not WIFEXITED(status)
+        or WEXITSTATUS(status) != 0) {
+      failed += " " + std::to_string(i_worker);
+    }
+  }
+  std::vector<std::size_t> claimed(queue + 1, queue + 1 + num_workers);
+  munmap(mapping, queue_bytes);
+  if (not failed.empty()) {
+    throw Exception("Workers", "Worker(s)" + failed
+        + " failed, their partial outputs are left for inspection.", false);
+  }
+
+  // merge the partial outputs by keeping everything in them
+  auto output_file{configuration.get<config::Parameters>("output_file")};
+  std::vector<std::string> partials;
+  for (int i_worker{0}; i_worker < num_workers; i_worker++) {
+    auto partial{partialName(output_file.get<std::string>("name"), i_worker)};
+    if (claimed.at(i_worker) > 0) partials.push_back(partial);
+    else std::filesystem::remove(partial);
+  }
+
+  config::Parameters merge_config{configuration};
+  config::Parameters keep_all;
+  keep_all.add<std::string>("regex", ".*");
+  keep_all.add("keep", true);
+  // the workers already decided which events to keep and there are
+  // no processors to give hints, so all of the events are kept
+  config::Parameters keep_events;
+  keep_events.add("default_keep", true);
+  merge_config.set("storage", keep_events);
+  merge_config.set("merge", true);
+  merge_config.set("input_files", partials);
+  merge_config.set("sequence", std::vector<config::Parameters>{});
+  merge_config.set("drop_keep_rules", std::vector<config::Parameters>{keep_all});
+  merge_config.set("conditions", config::Parameters{});
+  merge_config.set("event_limit", -1);
+  merge_config.set("first_entry", 0);
+  merge_config.set("last_entry", -1);
+  merge_config.set("threads", 1);
+  merge_config.set("pipeline", false);
+  merge_config.set("processor_threads", 1);
+  merge_config.set("lazy_load", false);
+  // the merge would replace the timing table and trace of the workers
+  merge_config.set("timing", false);
+  merge_config.set("counters", false);
+  merge_config.set<std::string>("trace_file", "");
+  {
+    Process merger{merge_config};
+    merger.run();
+  }
+  for (const auto& partial : partials) std::filesystem::remove(partial);
+}
+
+}  // namespace fire
@@ -0,0 +1,82 @@
+#include "fire/io/IOThread.h"
+
+namespace fire::io {
+
+std::recursive_mutex& hdf5_mutex() {
+  static std::recursive_mutex the_mutex;
+  return the_mutex;
+}
+
+IOThread::IOThread(std::size_t max_in_flight, std::size_t num_threads)
+    : max_in_flight_{max_in_flight > 0 ? max_in_flight : 1} {
+  if (num_threads == 0) num_threads = 1;
+  for (std::size_t i{0}; i < num_threads; i++)
+    threads_.emplace_back(&IOThread::loop, this);
+}
+
+IOThread::~IOThread() {
+  {
+    std::lock_guard<std::mutex> lock{mutex_};
+    stop_ = true;
+  }
+  job_ready_.notify_all();
+  for (auto& thread : threads_) thread.join();
+}
+
+void IOThread::submit(std::function<void()> job) {
+  std::unique_lock<std::mutex> lock{mutex_};
+  job_done_.wait(lock, [this] {
+    return error_ or queue_.size() + running_ < max_in_flight_;
+  });
+  rethrow();
+  queue_.push_back(std::move(job));
+  lock.unlock();
+  job_ready_.notify_one();
+}
+
+void IOThread::wait() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  job_done_.wait(lock, [this] {
+    return error_ or (queue_.empty() and running_ == 0);
+  });
+  rethrow();
+}
+
+void IOThread::loop() {
+  std::unique_lock<std::mutex> lock{mutex_};
+  while (true) {
+    job_ready_.wait(lock, [this] { return stop_ or not queue_.empty(); });
+    // only stop once the remaining jobs are done
+    if (queue_.empty()) break;
+    auto job{std::move(queue_.front())};
+    queue_.pop_front();
+    running_++;
+    lock.unlock();
+    std::exception_ptr error;
+    try {
+      job();
+    } catch (...) {
+      error = std::current_exception();
+    }
+    lock.lock();
+    running_--;
+    if (error) {
+      // keep the first exception and drop the jobs that were
+      // waiting behind the one that failed
+      if (not error_) error_ = error;
+      queue_.clear();
+    }
+    job_done_.notify_all();
+  }
+}
+
+void IOThread::rethrow() {
+  if (error_) {
+    // only throw the exception once, later jobs can still be run
+    auto e{error_};
+    error_ = nullptr;
+    std::rethrow_exception(e);
+  }
+}
+
+}  // namespace fire::io
@@ -4,7 +4,8 @@
 
 namespace fire::io {
 
-std::unique_ptr<io::Reader> open(const std::string& fp) {
+std::unique_ptr<io::Reader> open(const std::string& fp,
+    const config::Parameters& ps) {
   static const std::map<std::string, std::string> ext_to_type = {
     { "root", "fire::io::root::Reader" },
     { "hdf5", "fire::io::h5::Reader" },
@@ -12,7 +13,7 @@ std::unique_ptr<io::Reader> open(const std::string& fp) {
   };
   auto ext{fp.substr(fp.find_last_of('.')+1)};
   try {
-    return io::Reader::Factory::get().make(ext_to_type.at(ext), fp);
+    return io::Reader::Factory::get().make(ext_to_type.at(ext), fp, ps);
   } catch (const std::out_of_range&) {
     throw Exception("BadExt",
         "Unrecognized extension '"+ext+"' for input file "+fp+".");
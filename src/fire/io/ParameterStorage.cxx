@@ -19,10 +19,20 @@ Data<ParameterStorage>::Data(const std::string& path, Reader* input_file, Parame
     : AbstractData<ParameterStorage>(path, input_file, handle), input_file_{input_file} {}
 
 void Data<ParameterStorage>::load(h5::Reader& r) {
-  static bool first_load{true};
-  if (first_load) {
-    first_load = false;
+  discover(r);
+  for (auto& [name, set] : parameters_) set->load(r);
+}
+
+void Data<ParameterStorage>::seek(h5::Reader& r, std::size_t i_row) {
+  discover(r);
+  for (auto& [name, set] : parameters_) set->seek(r, i_row);
+}
+
+void Data<ParameterStorage>::discover(h5::Reader& r) {
+  if (not discovered_) {
+    discovered_ = true;
     // first load - discovery - look through file to find parameters on disk
+    std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
     for (auto pname : r.list(this->path_)) {
       std::string path{this->path_+"/"+pname};
       auto type{r.getDataSetType(path).getClass()};
@@ -41,7 +51,6 @@ void Data<ParameterStorage>::load(h5::Reader& r) {
       }
     }
   }
-  for (auto& [name, set] : parameters_) set->load(r);
 }
 
 void Data<ParameterStorage>::save(Writer& w) {
@@ -0,0 +1,127 @@
+#include "fire/io/Trace.h"
+
+#include <unistd.h>
+
+#include "fire/exception/Exception.h"
+
+namespace fire::io {
+
+namespace {
+
+/**
+ * Get the index of the calling thread
+ *
+ * The threads are numbered in the order they first record a span
+ * which keeps the thread ids on the timeline small.
+ *
+ * @return index of the calling thread
+ */
+std::size_t threadIndex() {
+  static std::atomic<std::size_t> next{0};
+  thread_local std::size_t index{next++};
+  return index;
+}
+
+/**
+ * Write the input string as a JSON string
+ * @param[in] o stream to write to
+ * @param[in] s string to write
+ */
+void writeString(std::ostream& o, const std::string& s) {
+  static const char* hex = "0123456789abcdef";
+  o << '"';
+  for (char c : s) {
+    if (c == '"' or c == '\\') {
+      o << '\\' << c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      o << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+    } else {
+      o << c;
+    }
+  }
+  o << '"';
+}
+
+}  // namespace
+
+void Trace::open(const std::string& file, std::size_t every) {
+  std::lock_guard<std::mutex> lock{mutex_};
+  enabled_.store(false, std::memory_order_release);
+  records_.clear();
+  if (out_.is_open()) out_.close();
+  out_.clear();
+  out_.open(file);
+  if (not out_) {
+    throw Exception("TraceWrite", "Unable to open trace file " + file, false);
+  }
+  file_ = file;
+  every_ = every > 0 ? every : 1;
+  out_ << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+  out_ << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << long(getpid())
+       << ",\"tid\":0,\"args\":{\"name\":\"fire\"}}";
+  opened_ = std::chrono::steady_clock::now();
+  enabled_.store(true, std::memory_order_release);
+}
+
+void Trace::close() {
+  std::lock_guard<std::mutex> lock{mutex_};
+  if (not enabled()) return;
+  enabled_.store(false, std::memory_order_release);
+  flush();
+  out_ << "\n]}\n";
+  out_.close();
+  std::string file;
+  file.swap(file_);
+  if (not out_) {
+    throw Exception("TraceWrite", "Unable to write trace file " + file, false);
+  }
+}
+
+void Trace::flush() {
+  long int pid{getpid()};
+  for (const auto& r : records_) {
+    out_ << ",\n{\"name\":";
+    writeString(out_, r.name);
+    out_ << ",\"cat\":\"" << r.category << "\",\"ph\":\"X\",\"ts\":" << r.start
+         << ",\"dur\":" << r.duration << ",\"pid\":" << pid << ",\"tid\":" << r.thread;
+    if (not r.detail.empty()) {
+      out_ << ",\"args\":{\"detail\":";
+      writeString(out_, r.detail);
+      out_ << "}";
+    }
+    out_ << "}";
+  }
+  records_.clear();
+}
+
+Trace::Span::Span(const std::string& name, const char* category, bool record,
+                  const std::string& detail)
+    : record_{record and enabled()}, category_{category} {
+  if (not record_) return;
+  name_ = name;
+  detail_ = detail;
+  start_ = std::chrono::steady_clock::now();
+}
+
+Trace::Span::~Span() {
+  if (not record_) return;
+  Trace::record(std::move(name_), category_, std::move(detail_), start_,
+                std::chrono::steady_clock::now());
+}
+
+void Trace::record(std::string&& name, const char* category, std::string&& detail,
+                   std::chrono::steady_clock::time_point start,
+                   std::chrono::steady_clock::time_point end) {
+  std::size_t thread{threadIndex()};
+  std::lock_guard<std::mutex> lock{mutex_};
+  // the tracer may have been closed or re-opened while the span was open
+  if (not enabled() or start < opened_) return;
+  using us = std::chrono::duration<double, std::micro>;
+  records_.push_back({std::move(name), category, std::move(detail),
+                      us(start - opened_).count(), us(end - start).count(), thread});
+  // the spans are written while holding the mutex so none are written
+  // after the file is closed
+  if (records_.size() >= FLUSH_RECORDS) flush();
+}
+
+}  // namespace fire::io
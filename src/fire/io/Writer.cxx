@@ -1,11 +1,79 @@
 #include "fire/io/Writer.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+
+#include <H5Dpublic.h>
+#include <H5Ppublic.h>
+#include <H5Tpublic.h>
+#include <H5Zpublic.h>
+#include <zlib.h>
+
 #include "fire/io/Constants.h"
+#include "fire/io/Reader.h"
 
 namespace fire::io {
 
+namespace {
+
+/**
+ * A registered HDF5 filter plugin applied to the created datasets
+ *
+ * HighFive only wraps the filters built into HDF5 (like Deflate),
+ * so this applies any registered filter by its ID. The filter ID
+ * and its parameters are stored in the dataset creation properties
+ * within the file, so readers that have the plugin available
+ * decompress the data without any configuration.
+ */
+class Filter {
+ public:
+  /**
+   * Define the filter to apply
+   *
+   * @throws Exception if the filter is not available to HDF5
+   * @param[in] name human-readable name of filter for error messages
+   * @param[in] id registered ID of the HDF5 filter
+   * @param[in] cd_values parameters to pass to the filter
+   */
+  Filter(const std::string& name, H5Z_filter_t id, std::vector<unsigned int> cd_values)
+      : id_{id}, cd_values_{std::move(cd_values)} {
+    if (H5Zfilter_avail(id_) <= 0) {
+      throw Exception("Config",
+          "The '"+name+"' compression filter (HDF5 filter "+std::to_string(id_)
+          +") is not available.\n"
+          "    Make sure the HDF5 filter plugins are installed and HDF5_PLUGIN_PATH "
+          "points to them.", false);
+    }
+  }
+
+  /**
+   * Apply the filter to the input creation property list
+   *
+   * @param[in] hid ID of dataset creation property list
+   */
+  void apply(hid_t hid) const {
+    if (H5Pset_filter(hid, id_, H5Z_FLAG_MANDATORY, 
+                      cd_values_.size(), cd_values_.data()) < 0) {
+      throw Exception("Config",
+          "Unable to add HDF5 filter "+std::to_string(id_)+" to the output datasets.",
+          false);
+    }
+  }
+
+ private:
+  /// registered ID of filter
+  H5Z_filter_t id_;
+  /// parameters for filter
+  std::vector<unsigned int> cd_values_;
+};
+
+}  // namespace
+
 Writer::Writer(const int& event_limit, const config::Parameters& ps)
-    : create_props_{},
+    : id_{0},
+      create_props_{},
       space_(std::vector<std::size_t>({0}), 
           std::vector<std::size_t>({HighFive::DataSpace::UNLIMITED})) {
   auto filename{ps.get<std::string>("name")};
@@ -15,29 +83,268 @@ Writer::Writer(const int& event_limit, const config::Parameters& ps)
         "         Use `p.output_file = 'my-file.h5'` in your python config.",
         false);
   }
-  file_ = std::make_unique<HighFive::File>(filename,
-        HighFive::File::Create | HighFive::File::Truncate);
+  static std::atomic<std::size_t> next_id{1};
+  id_ = next_id++;
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
   // down here with = to allow implicit cast from 'int' to 'std::size_t'
   entries_ = event_limit;
   rows_per_chunk_ = ps.get<int>("rows_per_chunk");
+  chunk_bytes_ = std::max(ps.get<int>("chunk_bytes", 0), 0);
+  chunk_adapt_events_ = std::max(ps.get<int>("chunk_adapt_events", 0), 0);
+  events_ = 0;
+  memory_budget_ = std::max(ps.get<int>("memory_budget", 0), 0) * 1000000ul;
   // copy creation properties into HighFive structure
-  create_props_.add(HighFive::Chunking({rows_per_chunk_}));
-  if (ps.get<bool>("shuffle")) create_props_.add(HighFive::Shuffle());
-  create_props_.add(HighFive::Deflate(ps.get<int>("compression_level")));
+  //  this is done before creating the file so that a bad
+  //  compression configuration does not truncate the file
+  //  the chunking is set per dataset in create_dataset
+  auto compression{ps.get<std::string>("compression", "deflate")};
+  unsigned int level = ps.get<int>("compression_level");
+  bool shuffle{ps.get<bool>("shuffle")};
+  if (compression == "deflate") {
+    if (shuffle) create_props_.add(HighFive::Shuffle());
+    create_props_.add(HighFive::Deflate(level));
+  } else if (compression == "zstd") {
+    if (shuffle) create_props_.add(HighFive::Shuffle());
+    create_props_.add(Filter(compression, 32015, {level}));
+  } else if (compression == "lz4") {
+    // zero block size means use the default block size
+    if (shuffle) create_props_.add(HighFive::Shuffle());
+    create_props_.add(Filter(compression, 32004, {0}));
+  } else if (compression == "blosc") {
+    // the first four parameters are filled in by the filter itself,
+    // then the level, the shuffle (2 is bitshuffle), and the
+    // compressor used within Blosc (1 is LZ4)
+    create_props_.add(Filter(compression, 32001, 
+          {0, 0, 0, 0, level, shuffle ? 2u : 0u, 1}));
+  } else if (compression != "none") {
+    throw Exception("Config",
+        "Unrecognized compression '"+compression+"'.\n"
+        "    Options are 'deflate', 'zstd', 'lz4', 'blosc', or 'none'.",
+        false);
+  }
+  file_ = std::make_unique<HighFive::File>(filename,
+        HighFive::File::Create | HighFive::File::Truncate);
+  if (ps.get<bool>("async_write", false)) {
+    io_thread_ = std::make_unique<IOThread>(ps.get<int>("max_in_flight", 4));
+  }
+  int compression_threads{ps.get<int>("compression_threads", 0)};
+  if (compression_threads > 0) {
+    if (compression != "deflate") {
+      throw Exception("Config",
+          "Compressing on multiple threads is only supported for 'deflate' compression.",
+          false);
+    }
+    compressor_ = std::make_unique<ChunkCompressor>(compression_threads, level, shuffle);
+  }
 }
 
-Writer::~Writer() { this->flush(); }
+Writer::~Writer() {
+  this->flush();
+  // join the threads before the buffers they could be writing are destroyed
+  io_thread_.reset();
+  compressor_.reset();
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+  buffers_.clear();
+  file_.reset();
+}
+
+void Writer::padObject(const std::string& path, std::size_t n) {
+  if (n == 0) return;
+  auto within = [](const std::string& full, const std::string& group) {
+    return full.size() > group.size() and full.compare(0, group.size(), group) == 0
+           and full[group.size()] == '/';
+  };
+  // the groups of the containers within the object
+  std::vector<std::string> containers;
+  for (const auto& [buff_path, _] : buffers_) {
+    if (buff_path != path and not within(buff_path, path)) continue;
+    std::size_t slash{buff_path.rfind('/')};
+    if (buff_path.substr(slash + 1) == constants::SIZE_NAME)
+      containers.push_back(buff_path.substr(0, slash));
+  }
+  for (auto& [buff_path, buff] : buffers_) {
+    if (buff_path != path and not within(buff_path, path)) continue;
+    bool content{std::any_of(containers.begin(), containers.end(),
+        [&](const std::string& container) {
+          return within(buff_path, container)
+                 and buff_path != container + "/" + constants::SIZE_NAME;
+        })};
+    if (not content) buff->pad(n);
+  }
+}
 
 void Writer::flush() {
+  // the readers forget us as they finish, so finish a copy of the list
+  auto readers{std::move(copying_)};
+  copying_.clear();
+  for (Reader* reader : readers) reader->finishCopies();
+  create_pending();
   for (auto& [path, buff] : buffers_) {
     buff->flush();
   }
+  if (io_thread_) io_thread_->wait();
+  if (compressor_) compressor_->wait();
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
   file_->flush();
 }
 
+void Writer::copying(Reader& reader) {
+  if (std::find(copying_.begin(), copying_.end(), &reader) == copying_.end())
+    copying_.push_back(&reader);
+}
+
+void Writer::doneCopying(Reader& reader) {
+  copying_.erase(std::remove(copying_.begin(), copying_.end(), &reader),
+                 copying_.end());
+}
+
+void Writer::time(Timing& timing) {
+  timing_ = &timing;
+  write_timer_ = timing.add("Writer::flush");
+  if (compressor_) compressor_->time(timing, timing.add("Writer::compress"));
+}
+
+void Writer::nextEvent() {
+  events_++;
+  if (events_ == chunk_adapt_events_) create_pending();
+  enforce_budget();
+}
+
+std::size_t Writer::chunk_length(const BufferHandle& buff) const {
+  std::size_t len{rows_per_chunk_};
+  if (chunk_bytes_ > 0 and buff.rowSize() > 0) {
+    len = std::max<std::size_t>(chunk_bytes_ / buff.rowSize(), 1);
+  }
+  // entries_ wraps around to a huge number if there is no event limit
+  if (chunk_adapt_events_ > 0 and events_ > 0 and static_cast<int>(entries_) > 0) {
+    double rows_per_event{double(buff.rows())/events_};
+    auto expected{static_cast<std::size_t>(std::ceil(rows_per_event*entries_))};
+    len = std::min(len, std::max<std::size_t>(expected, 1));
+  }
+  return len;
+}
+
+void Writer::create_pending() {
+  for (auto& [path, buff] : buffers_) {
+    if (not buff->created()) buff->create(chunk_length(*buff));
+  }
+}
+
+void Writer::enforce_budget() {
+  auto total_bytes = [this]() {
+    std::size_t total{0};
+    for (const auto& [_, buff] : buffers_) total += buff->bytes();
+    return total;
+  };
+  std::size_t total{total_bytes()};
+  peak_bytes_ = std::max(peak_bytes_, total);
+  while (memory_budget_ > 0 and total > memory_budget_) {
+    // largest buffer that can be released
+    BufferHandle* largest{nullptr};
+    for (auto& [_, buff] : buffers_) {
+      if (buff->created() and buff->bytes() > (largest ? largest->bytes() : 0))
+        largest = buff.get();
+    }
+    if (not largest) break;
+    largest->release();
+    total = total_bytes();
+  }
+}
+
+bool Writer::same_layout(hid_t src, hid_t dst, std::size_t chunk_len) {
+  hid_t src_type{H5Dget_type(src)}, dst_type{H5Dget_type(dst)};
+  // variable-length data lives in a heap outside of the chunks
+  bool same{H5Tequal(src_type, dst_type) > 0
+    and H5Tis_variable_str(src_type) == 0
+    and H5Tdetect_class(src_type, H5T_VLEN) == 0};
+  H5Tclose(src_type);
+  H5Tclose(dst_type);
+  if (not same) return false;
+
+  hid_t src_plist{H5Dget_create_plist(src)}, dst_plist{H5Dget_create_plist(dst)};
+  hsize_t src_chunk[1] = {0};
+  same = H5Pget_layout(src_plist) == H5D_CHUNKED
+      and H5Pget_chunk(src_plist, 1, src_chunk) == 1
+      and src_chunk[0] == chunk_len
+      and H5Pget_nfilters(src_plist) == H5Pget_nfilters(dst_plist);
+  for (int i_filter{0}; same and i_filter < H5Pget_nfilters(src_plist); i_filter++) {
+    // the filters and their parameters need to match in order
+    unsigned int src_flags, dst_flags, src_cd[16], dst_cd[16];
+    std::size_t src_ncd{16}, dst_ncd{16};
+    H5Z_filter_t src_id{H5Pget_filter2(src_plist, i_filter, &src_flags, &src_ncd, src_cd,
+                                       0, nullptr, nullptr)};
+    H5Z_filter_t dst_id{H5Pget_filter2(dst_plist, i_filter, &dst_flags, &dst_ncd, dst_cd,
+                                       0, nullptr, nullptr)};
+    same = src_id >= 0 and src_id == dst_id and src_ncd == dst_ncd
+      and std::equal(src_cd, src_cd + std::min<std::size_t>(src_ncd, 16), dst_cd);
+  }
+  H5Pclose(src_plist);
+  H5Pclose(dst_plist);
+  return same;
+}
+
+void Writer::copy_chunk(hid_t src, std::size_t i_src, hid_t dst, std::size_t i_dst) {
+  hsize_t src_offset[1] = {i_src}, dst_offset[1] = {i_dst};
+  hsize_t size;
+  if (H5Dget_chunk_storage_size(src, src_offset, &size) < 0) {
+    throw Exception("H5Copy", "Unable to find the size of a chunk to copy.", false);
+  }
+  std::vector<char> chunk(size);
+  uint32_t filter_mask;
+  if (H5Dread_chunk(src, H5P_DEFAULT, src_offset, &filter_mask, chunk.data()) < 0) {
+    throw Exception("H5Copy", "Unable to read a chunk to copy.", false);
+  }
+  // the filter mask records any filters that were skipped for this chunk
+  if (H5Dwrite_chunk(dst, H5P_DEFAULT, filter_mask, dst_offset, size, chunk.data()) < 0) {
+    throw Exception("H5Copy", "Unable to write a copied chunk.", false);
+  }
+}
+
+Writer::ChunkCompressor::ChunkCompressor(std::size_t num_threads, unsigned int level,
+                                         bool shuffle)
+    : level_{level}, shuffle_{shuffle}, pool_{2*num_threads, num_threads} {}
+
+void Writer::ChunkCompressor::submit(hid_t set, std::size_t i_file, const char* chunk,
+    std::size_t chunk_len, std::size_t elem_size, std::shared_ptr<const void> keep_alive) {
+  pool_.submit([this, set, i_file, chunk, chunk_len, elem_size, keep_alive]() {
+    Timing::Scope scope{timing_, timer_};
+    Trace::Span span{"Writer::compress", "io"};
+    std::size_t nbytes{chunk_len*elem_size};
+    const Bytef* src{reinterpret_cast<const Bytef*>(chunk)};
+    // the HDF5 Shuffle filter groups the i'th byte of every element together
+    std::vector<Bytef> shuffled;
+    if (shuffle_ and elem_size > 1) {
+      shuffled.resize(nbytes);
+      for (std::size_t i_byte{0}; i_byte < elem_size; i_byte++) {
+        for (std::size_t i_elem{0}; i_elem < chunk_len; i_elem++) {
+          shuffled[i_byte*chunk_len + i_elem] = src[i_elem*elem_size + i_byte];
+        }
+      }
+      src = shuffled.data();
+    }
+    // the HDF5 Deflate filter is a zlib stream
+    uLongf compressed_size{compressBound(nbytes)};
+    std::vector<Bytef> compressed(compressed_size);
+    if (compress2(compressed.data(), &compressed_size, src, nbytes, level_) != Z_OK) {
+      throw Exception("H5Write", "Unable to compress a chunk with zlib.", false);
+    }
+    hsize_t offset[1] = {i_file};
+    std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+    // a filter mask of zero means all of the filters were applied
+    if (H5Dwrite_chunk(set, H5P_DEFAULT, 0, offset, compressed_size, compressed.data()) < 0) {
+      throw Exception("H5Write", "Unable to write a compressed chunk to disk.", false);
+    }
+  });
+}
+
+void Writer::ChunkCompressor::wait() {
+  pool_.wait();
+}
+
 const std::string& Writer::name() const { return file_->getName(); }
 
 void Writer::structure(const std::string& full_path, const std::pair<std::string,int>& type) {
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
   if (file_->exist(full_path)) {
     // group already been written to, check that we are the same
     auto grp = file_->getGroup(full_path);
@@ -1,41 +1,138 @@
 #include "fire/io/h5/Reader.h"
 
+#include <atomic>
+#include <limits>
+#include <numeric>
+
+#include <H5Dpublic.h>
+#include <H5Ppublic.h>
+
 #include "fire/io/Constants.h"
 #include "fire/io/Data.h"
 
 namespace fire::io::h5 {
 
-Reader::Reader(const std::string& name) 
-  : file_{name},
-    entries_{file_.getDataSet(
-        constants::EVENT_GROUP + "/" 
-      + constants::EVENT_HEADER_NAME + "/" 
-      + constants::NUMBER_NAME).getDimensions().at(0)},
-    runs_{file_.getDataSet(
+Reader::Reader(const std::string& name, const config::Parameters& ps)
+  : ::fire::io::Reader(name) {
+  static std::atomic<std::size_t> next_id{1};
+  id_ = next_id++;
+  memory_budget_ = std::max(ps.get<int>("memory_budget", 0), 0) * 1000000ul;
+  if (ps.get<bool>("prefetch", false)) {
+    // each buffer has at most one chunk in flight,
+    // so we do not need to bound the queue any further
+    prefetch_ = std::make_unique<IOThread>(
+        std::numeric_limits<std::size_t>::max());
+  }
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+  file_ = std::make_unique<HighFive::File>(name);
+  // the event header is only written once an event is saved,
+  // so a file where all of the events were dropped has no entries
+  std::string event_numbers{constants::EVENT_GROUP + "/"
+      + constants::EVENT_HEADER_NAME + "/" + constants::NUMBER_NAME};
+  entries_ = file_->exist(event_numbers)
+      ? file_->getDataSet(event_numbers).getDimensions().at(0) : 0;
+  runs_ = file_->getDataSet(
         constants::RUN_HEADER_NAME+"/"+
         constants::NUMBER_NAME)
-      .getDimensions().at(0)},
-   ::fire::io::Reader(name) {}
+      .getDimensions().at(0);
+}
+
+Reader::~Reader() {
+  // the writers we are copying into may outlive us
+  finishCopies();
+  // finish the prefetching reads before closing, they need the hdf5_mutex
+  prefetch_.reset();
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+  mirror_objects_.clear();
+  buffers_.clear();
+  file_.reset();
+}
+
+double Reader::prefetchStallTime() const {
+  std::chrono::duration<double> total{0.};
+  for (const auto& [_, buff] : buffers_) total += buff->stall();
+  return total.count();
+}
 
 void Reader::load_into(BaseData& d) {
   d.load(*this);
 }
 
-std::string Reader::name() const { return file_.getName(); }
+void Reader::seek_into(BaseData& d, std::size_t i_entry) {
+  d.seek(*this, i_entry);
+}
+
+void Reader::skip_into(BaseData& d, std::size_t i_entry, std::size_t /*n*/) {
+  d.seek(*this, i_entry);
+}
+
+std::string Reader::name() const { return file_->getName(); }
 
 std::vector<std::string> Reader::list(const std::string& group_path) const {
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
   // just return empty list of group does not exist
-  if (not file_.exist(group_path)) return {};
-  return file_.getGroup(group_path).listObjectNames();
+  if (not file_->exist(group_path)) return {};
+  return file_->getGroup(group_path).listObjectNames();
 }
 
 HighFive::DataType Reader::getDataSetType(
     const std::string& dataset) const {
-  return file_.getDataSet(dataset).getDataType();
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+  return file_->getDataSet(dataset).getDataType();
+}
+
+std::size_t Reader::offset(const std::string& size_path, std::size_t i_row) {
+  auto it{offsets_.find(size_path)};
+  if (it == offsets_.end()) {
+    std::vector<std::size_t> sizes;
+    {
+      std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+      file_->getDataSet(size_path).read(sizes);
+    }
+    // offsets[i] is the sum of the sizes before row i
+    std::vector<std::size_t> offsets(sizes.size()+1, 0);
+    std::partial_sum(sizes.begin(), sizes.end(), offsets.begin()+1);
+    it = offsets_.emplace(size_path, std::move(offsets)).first;
+  }
+  return it->second.at(i_row);
+}
+
+std::size_t Reader::chunk_length(const HighFive::DataSet& ds) const {
+  std::size_t len{rows_per_chunk_};
+  hid_t plist{H5Dget_create_plist(ds.getId())};
+  hsize_t chunk[1];
+  if (plist >= 0 and H5Pget_layout(plist) == H5D_CHUNKED
+      and H5Pget_chunk(plist, 1, chunk) == 1 and chunk[0] > 0) {
+    len = chunk[0];
+  }
+  if (plist >= 0) H5Pclose(plist);
+  return len;
+}
+
+void Reader::enforce_budget() {
+  auto total_bytes = [this]() {
+    std::size_t total{0};
+    for (const auto& [_, buff] : buffers_) total += buff->bytes();
+    return total;
+  };
+  std::size_t total{total_bytes()};
+  while (memory_budget_ > 0 and total > memory_budget_) {
+    // largest buffer that can still shrink
+    BufferHandle* largest{nullptr};
+    for (auto& [_, buff] : buffers_) {
+      if (buff->bytes() > (largest ? largest->bytes() : 0) and buff->canShrink())
+        largest = buff.get();
+    }
+    if (not largest) break;
+    largest->shrink();
+    total = total_bytes();
+  }
+  peak_bytes_ = std::max(peak_bytes_, total);
 }
 
 HighFive::ObjectType Reader::getH5ObjectType(const std::string& path) const {
-  return file_.getObjectType(path);
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
+  return file_->getObjectType(path);
 }
 
 std::vector<std::pair<std::string,std::string>> Reader::availableObjects() {
@@ -54,14 +151,15 @@ std::vector<std::pair<std::string,std::string>> Reader::availableObjects() {
 }
 
 std::pair<std::string,int> Reader::type(const std::string& path) {
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
   HighFive::Attribute type_attr = 
     getH5ObjectType(path) == HighFive::ObjectType::Dataset
-          ? file_.getDataSet(path).getAttribute(constants::TYPE_ATTR_NAME)
-          : file_.getGroup(path).getAttribute(constants::TYPE_ATTR_NAME);
+          ? file_->getDataSet(path).getAttribute(constants::TYPE_ATTR_NAME)
+          : file_->getGroup(path).getAttribute(constants::TYPE_ATTR_NAME);
   HighFive::Attribute vers_attr = 
     getH5ObjectType(path) == HighFive::ObjectType::Dataset
-          ? file_.getDataSet(path).getAttribute(constants::VERS_ATTR_NAME)
-          : file_.getGroup(path).getAttribute(constants::VERS_ATTR_NAME);
+          ? file_->getDataSet(path).getAttribute(constants::VERS_ATTR_NAME)
+          : file_->getGroup(path).getAttribute(constants::VERS_ATTR_NAME);
 
   std::string type;
   type_attr.read(type);
@@ -81,8 +179,9 @@ void Reader::mirror(const std::string& path, Writer& output) {
   for (auto& subgrp : this->list(path)) mirror(path+"/"+subgrp, output);
 }
 
-void Reader::copy(unsigned int long i_entry, const std::string& path, Writer& output) {
-  if (mirror_objects_.find(path) == mirror_objects_.end()) {
+Reader::MirrorObject& Reader::mirrorObject(const std::string& path, Writer& output) {
+  auto mirror_it{mirror_objects_.find(path)};
+  if (mirror_it == mirror_objects_.end()) {
     /**
      * this is where recursing into the subgroups of full_name occurs 
      * if this mirror object hasn't been created yet
@@ -98,40 +197,76 @@ void Reader::copy(unsigned int long i_entry, const std::string& path, Writer& ou
      * from the input file into the output file.
      */
     mirror(path, output);
-    mirror_objects_.emplace(std::make_pair(path,
-          std::make_unique<MirrorObject>(path, *this)));
+    mirror_it = mirror_objects_.emplace(path,
+          std::make_unique<MirrorObject>(path, *this)).first;
   }
-  // do the copying
-  mirror_objects_[path]->copy(i_entry, 1, output);
+  return *mirror_it->second;
+}
+
+void Reader::copy(unsigned int long i_entry, const std::string& path, Writer& output) {
+  auto& mirror_object{mirrorObject(path, output)};
+  // gather consecutive entries so they can be copied together
+  auto pending{pending_copies_.find(path)};
+  if (pending != pending_copies_.end()) {
+    auto& [start, n, writer] = pending->second;
+    if (writer == &output and i_entry == start + n) {
+      n++;
+      return;
+    }
+    mirror_object.copy(start, n, *writer);
+    Writer* previous{writer};
+    pending_copies_.erase(pending);
+    if (previous != &output and std::none_of(pending_copies_.begin(), pending_copies_.end(),
+          [previous](const auto& other) { return other.second.output == previous; }))
+      previous->doneCopying(*this);
+  }
+  pending_copies_.emplace(path, PendingCopy{i_entry, 1, &output});
+  output.copying(*this);
+}
+
+void Reader::pad(const std::string& path, std::size_t n, Writer& output) {
+  mirrorObject(path, output).pad(n, output);
+}
+
+void Reader::finishCopies() {
+  std::vector<Writer*> outputs;
+  for (auto& [path, pending] : pending_copies_) {
+    mirror_objects_[path]->copy(pending.start, pending.n, *pending.output);
+    outputs.push_back(pending.output);
+  }
+  pending_copies_.clear();
+  for (Writer* output : outputs) output->doneCopying(*this);
 }
 
 Reader::MirrorObject::MirrorObject(const std::string& path, Reader& reader) 
   : reader_{reader} {
+  // the HDF5 types are created and compared here
+  std::lock_guard<std::recursive_mutex> lock{hdf5_mutex()};
   if (reader_.getH5ObjectType(path) == HighFive::ObjectType::Dataset) {
     // simple atomic event object
     //  unfortunately, I can't think of a better solution than manually
     //  copying the code for all of the types
     HighFive::DataType type = reader_.getDataSetType(path);
     if (type == HighFive::create_datatype<int>()) {
-      data_ = std::make_unique<io::Data<int>>(path);
+      atomic<int>(path);
     } else if (type == HighFive::create_datatype<long int>()) {
-      data_ = std::make_unique<io::Data<long int>>(path);
+      atomic<long int>(path);
     } else if (type == HighFive::create_datatype<long long int>()) {
-      data_ = std::make_unique<io::Data<long long int>>(path);
+      atomic<long long int>(path);
     } else if (type == HighFive::create_datatype<unsigned int>()) {
-      data_ = std::make_unique<io::Data<unsigned int>>(path);
+      atomic<unsigned int>(path);
     } else if (type == HighFive::create_datatype<unsigned long int>()) {
-      data_ = std::make_unique<io::Data<unsigned long int>>(path);
+      atomic<unsigned long int>(path);
     } else if (type == HighFive::create_datatype<unsigned long long int>()) {
-      data_ = std::make_unique<io::Data<unsigned long long int>>(path);
+      atomic<unsigned long long int>(path);
     } else if (type == HighFive::create_datatype<float>()) {
-      data_ = std::make_unique<io::Data<float>>(path);
+      atomic<float>(path);
     } else if (type == HighFive::create_datatype<double>()) {
-      data_ = std::make_unique<io::Data<double>>(path);
+      atomic<double>(path);
     } else if (type == HighFive::create_datatype<std::string>()) {
-      data_ = std::make_unique<io::Data<std::string>>(path);
+      atomic<std::string>(path);
     } else if (type == HighFive::create_datatype<fire::io::Bool>()) {
-      data_ = std::make_unique<io::Data<bool>>(path);
+      atomic<bool>(path);
     } else {
       throw Exception("UnknownDS","Unable to deduce C++ type from H5 type during a copy\n"
         "    User could avoid this issue simply by accessing the event object within some processor during the first event.", 
@@ -144,7 +279,8 @@ Reader::MirrorObject::MirrorObject(const std::string& path, Reader& reader)
     for (auto& subobj : subobjs) {
       std::string sub_path{path + "/" + subobj};
       if (subobj == constants::SIZE_NAME) {
-        size_member_ = std::make_unique<io::Data<std::size_t>>(sub_path);
+        size_path_ = sub_path;
+        size_member_ = std::make_unique<MirrorObject>(sub_path, reader_);
       } else {
         obj_members_.emplace_back(std::make_unique<MirrorObject>(sub_path, reader_));
       }
@@ -152,44 +288,42 @@ Reader::MirrorObject::MirrorObject(const std::string& path, Reader& reader)
   }
 }
 
-void Reader::MirrorObject::copy(unsigned long int i_entry, unsigned long int n, Writer& output) {
-  unsigned long int num_to_advance{i_entry <= last_entry_ ? 0 : i_entry - last_entry_ - 1}, 
-                    num_to_save{n};
-  last_entry_ = i_entry;
-
-  // if we have a data member, the data member is the only part of this
-  // mirror object
-  if (data_) {
-    // load until one before desired entry
-    for (std::size_t i{0}; i < num_to_advance; i++) data_->load(reader_);
-    // load and save desired entries
-    for (std::size_t i{0}; i < num_to_save; i++) {
-      data_->load(reader_);
-      data_->save(output);
-    }
+void Reader::MirrorObject::copy(unsigned long int i_row, unsigned long int n, Writer& output) {
+  if (n == 0) return;
+
+  // if we have a dataset, the dataset is the only part of this mirror object
+  if (copy_rows_) {
+    copy_rows_(i_row, n, output);
     return;
   }
 
   /// if there is a member determining the size of each entry,
   /// we need to follow its lead
   if (size_member_) {
-    unsigned long int new_num_to_advance{0};
-    for (std::size_t i{0}; i < num_to_advance; i++) {
-      size_member_->load(reader_);
-      new_num_to_advance += dynamic_cast<Data<std::size_t>&>(*size_member_).get();
-    }
-    unsigned long int new_num_to_save = 0;
-    for (std::size_t i{0}; i < num_to_save; i++) {
-      size_member_->load(reader_);
-      new_num_to_save += dynamic_cast<Data<std::size_t>&>(*size_member_).get();
-      size_member_->save(output);
-    }
+    size_member_->copy(i_row, n, output);
+    unsigned long int start{reader_.offset(size_path_, i_row)};
+    n = reader_.offset(size_path_, i_row + n) - start;
+    i_row = start;
+  }
+
+  for (auto& obj : obj_members_) obj->copy(i_row, n, output);
+}
+
+void Reader::MirrorObject::pad(unsigned long int n, Writer& output) {
+  if (n == 0) return;
 
-    num_to_advance = new_num_to_advance;
-    num_to_save = new_num_to_save;
+  if (pad_rows_) {
+    pad_rows_(n, output);
+    return;
+  }
+
+  // the padded entries of a container are empty
+  if (size_member_) {
+    size_member_->pad(n, output);
+    return;
   }
 
-  for (auto& obj  : obj_members_) obj->copy(num_to_advance, num_to_save, output);
+  for (auto& obj : obj_members_) obj->pad(n, output);
 }
 
 }  // namespace fire::io::h5
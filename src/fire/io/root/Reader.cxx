@@ -10,7 +10,7 @@
 
 namespace fire::io::root {
 
-Reader::Reader(const std::string& file_name)
+Reader::Reader(const std::string& file_name, const config::Parameters& ps)
   : file_{TFile::Open(file_name.c_str())},
     ::fire::io::Reader(file_name) {
 
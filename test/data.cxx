@@ -3,6 +3,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <highfive/H5Easy.hpp>
+#include <H5Zpublic.h>
 
 #include "fire/EventHeader.h"
 #include "fire/RunHeader.h"
@@ -360,4 +361,533 @@ BOOST_AUTO_TEST_CASE(read, *boost::unit_test::depends_on("data/copy")) {
   }
 }
 
+BOOST_AUTO_TEST_CASE(seek, *boost::unit_test::depends_on("data/write")) {
+  fire::io::h5::Reader f{filename};
+
+  fire::EventHeader eh;
+  fire::io::Data<fire::EventHeader> event_header(fire::EventHeader::NAME,&f,&eh);
+  fire::io::Data<double> double_ds("double",&f);
+  fire::io::Data<std::vector<double>> vector_double_ds("vector_double",&f);
+  fire::io::Data<std::map<int,double>> map_int_double_ds("map_int_double",&f);
+  fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit",&f);
+  fire::io::Data<Cluster> cluster_ds("cluster",&f);
+  fire::io::Data<std::vector<Cluster>> vector_cluster_ds("vector_cluster",&f);
+
+  std::map<int,double> map_int_double;
+  for (std::size_t i{0}; i < ints.size(); i++) {
+    map_int_double[ints.at(i)] = doubles.at(i);
+  }
+  std::vector<Cluster> clusters;
+  clusters.emplace_back(2, all_hits.at(0));
+  clusters.emplace_back(3, all_hits.at(1));
+
+  // out of order and across chunks, without loading the entries between
+  for (std::size_t i_entry : {2, 0, 1, 1, 2}) {
+    BOOST_TEST_CHECKPOINT("seeking to entry " << i_entry);
+    f.seek_into(event_header, i_entry);
+    f.seek_into(double_ds, i_entry);
+    f.seek_into(vector_double_ds, i_entry);
+    f.seek_into(map_int_double_ds, i_entry);
+    f.seek_into(vector_hit_ds, i_entry);
+    f.seek_into(cluster_ds, i_entry);
+    f.seek_into(vector_cluster_ds, i_entry);
+
+    event_header.load(f);
+    BOOST_CHECK(eh.getEventNumber() == i_entry);
+    BOOST_CHECK(eh.get<int>("int") == i_entry);
+    BOOST_CHECK(load(double_ds,doubles.at(i_entry),f));
+    BOOST_CHECK(load(vector_double_ds,doubles,f));
+    BOOST_CHECK(load(map_int_double_ds,map_int_double,f));
+    BOOST_CHECK(load(vector_hit_ds,all_hits[i_entry],f));
+    BOOST_CHECK(load(cluster_ds,Cluster(i_entry, all_hits.at(i_entry)),f));
+    BOOST_CHECK(load(vector_cluster_ds,clusters,f));
+  }
+
+  // mirror objects seek to the entries they are asked to copy
+  static const std::string skip_file{"skip_"+filename};
+  {
+    fire::config::Parameters output_params;
+    output_params.add("name",skip_file);
+    output_params.add("rows_per_chunk",2);
+    output_params.add("compression_level", 6);
+    output_params.add("shuffle",false);
+    fire::io::Writer writer{2,output_params};
+    for (std::size_t i_entry : {2, 0}) {
+      f.copy(i_entry, fire::EventHeader::NAME, writer);
+      f.copy(i_entry, "vector_hit", writer);
+      f.copy(i_entry, "cluster", writer);
+    }
+    fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+    rh_d.structure(writer);
+    rh_d.save(writer);
+  }
+  fire::io::h5::Reader skipped{skip_file};
+  fire::io::Data<std::vector<Hit>> skipped_hits("vector_hit",&skipped);
+  fire::io::Data<Cluster> skipped_cluster("cluster",&skipped);
+  for (std::size_t i_entry : {2, 0}) {
+    BOOST_CHECK(load(skipped_hits,all_hits[i_entry],skipped));
+    BOOST_CHECK(load(skipped_cluster,Cluster(i_entry, all_hits.at(i_entry)),skipped));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(async_write) {
+  static std::string async_file{"async_"+filename};
+  static const std::size_t num_entries{100};
+  {
+    fire::config::Parameters output_params;
+    output_params.add("name",async_file);
+    output_params.add("rows_per_chunk",2);
+    output_params.add("compression_level", 6);
+    output_params.add("shuffle",false);
+    output_params.add("async_write",true);
+    output_params.add("max_in_flight",1);
+    fire::io::Writer f{int(num_entries),output_params};
+
+    fire::EventHeader eh;
+    fire::io::Data<fire::EventHeader> event_header(fire::EventHeader::NAME,nullptr,&eh);
+    fire::io::Data<double> double_ds("double");
+    fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit");
+    event_header.structure(f);
+    double_ds.structure(f);
+    vector_hit_ds.structure(f);
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      eh.setEventNumber(i_entry);
+      BOOST_CHECK(save(event_header,eh,f));
+      BOOST_CHECK(save(double_ds,double(i_entry),f));
+      BOOST_CHECK(save(vector_hit_ds,all_hits[i_entry%all_hits.size()],f));
+    }
+    fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+    rh_d.structure(f);
+    rh_d.save(f);
+  }
+
+  fire::io::h5::Reader f{async_file};
+  BOOST_CHECK(f.entries() == num_entries);
+  fire::io::Data<double> double_ds("double",&f);
+  fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit",&f);
+  for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+    BOOST_CHECK(load(double_ds,double(i_entry),f));
+    BOOST_CHECK(load(vector_hit_ds,all_hits[i_entry%all_hits.size()],f));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(prefetch) {
+  static std::string prefetch_file{"prefetch_"+filename};
+  // more entries than the reader keeps in one chunk
+  static const std::size_t num_entries{25000};
+  {
+    fire::config::Parameters output_params;
+    output_params.add("name",prefetch_file);
+    output_params.add("rows_per_chunk",1000);
+    output_params.add("compression_level", 6);
+    output_params.add("shuffle",false);
+    fire::io::Writer f{int(num_entries),output_params};
+
+    fire::EventHeader eh;
+    fire::io::Data<fire::EventHeader> event_header(fire::EventHeader::NAME,nullptr,&eh);
+    fire::io::Data<double> double_ds("double");
+    fire::io::Data<bool> bool_ds("bool");
+    fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit");
+    event_header.structure(f);
+    double_ds.structure(f);
+    bool_ds.structure(f);
+    vector_hit_ds.structure(f);
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      eh.setEventNumber(i_entry);
+      BOOST_CHECK(save(event_header,eh,f));
+      BOOST_CHECK(save(double_ds,double(i_entry),f));
+      BOOST_CHECK(save(bool_ds,i_entry%3==0,f));
+      BOOST_CHECK(save(vector_hit_ds,all_hits[i_entry%all_hits.size()],f));
+    }
+    fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+    rh_d.structure(f);
+    rh_d.save(f);
+  }
+
+  fire::config::Parameters reader_params;
+  reader_params.add("prefetch",true);
+  fire::io::h5::Reader f{prefetch_file,reader_params};
+  BOOST_CHECK(f.entries() == num_entries);
+  fire::io::Data<double> double_ds("double",&f);
+  fire::io::Data<bool> bool_ds("bool",&f);
+  fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit",&f);
+  for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+    BOOST_CHECK(load(double_ds,double(i_entry),f));
+    BOOST_CHECK(load(bool_ds,i_entry%3==0,f));
+    BOOST_CHECK(load(vector_hit_ds,all_hits[i_entry%all_hits.size()],f));
+  }
+  BOOST_CHECK(f.prefetchStallTime() >= 0.);
+}
+
+BOOST_AUTO_TEST_CASE(compression) {
+  static const std::size_t num_entries{100};
+  auto write = [](const std::string& compression) {
+    fire::config::Parameters output_params;
+    output_params.add<std::string>("name",compression+"_"+filename);
+    output_params.add("rows_per_chunk",10);
+    output_params.add("compression_level", 1);
+    output_params.add("shuffle",true);
+    output_params.add("compression",compression);
+    fire::io::Writer f{int(num_entries),output_params};
+    fire::io::Data<fire::EventHeader> event_header(fire::EventHeader::NAME);
+    fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit");
+    event_header.structure(f);
+    vector_hit_ds.structure(f);
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      fire::EventHeader eh;
+      eh.setEventNumber(i_entry);
+      save(event_header,eh,f);
+      save(vector_hit_ds,all_hits[i_entry%all_hits.size()],f);
+    }
+    fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+    rh_d.structure(f);
+    rh_d.save(f);
+  };
+  auto read = [](const std::string& compression) {
+    fire::io::h5::Reader f{compression+"_"+filename};
+    fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit",&f);
+    bool all_good{true};
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      all_good = all_good and load(vector_hit_ds,all_hits[i_entry%all_hits.size()],f);
+    }
+    return all_good;
+  };
+
+  BOOST_CHECK_THROW(write("bogus"), fire::Exception);
+  for (const std::string compression : {"none", "deflate", "zstd", "lz4", "blosc"}) {
+    // plugins may not be available in the testing environment
+    if (compression == "zstd" and H5Zfilter_avail(32015) <= 0) continue;
+    if (compression == "lz4" and H5Zfilter_avail(32004) <= 0) continue;
+    if (compression == "blosc" and H5Zfilter_avail(32001) <= 0) continue;
+    BOOST_TEST_CHECKPOINT("compression " << compression);
+    write(compression);
+    BOOST_CHECK(read(compression));
+  }
+  if (H5Zfilter_avail(32015) <= 0) {
+    BOOST_CHECK_THROW(write("zstd"), fire::Exception);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(parallel_compression) {
+  // not a multiple of the chunk size so the last chunk is partial
+  static const std::size_t num_entries{95};
+  auto write = [](const std::string& name, int compression_threads, bool async) {
+    fire::config::Parameters output_params;
+    output_params.add<std::string>("name",name);
+    output_params.add("rows_per_chunk",10);
+    output_params.add("compression_level", 6);
+    output_params.add("shuffle",true);
+    output_params.add("compression_threads",compression_threads);
+    output_params.add("async_write",async);
+    fire::io::Writer f{int(num_entries),output_params};
+    fire::EventHeader eh;
+    fire::io::Data<fire::EventHeader> event_header(fire::EventHeader::NAME,nullptr,&eh);
+    fire::io::Data<double> double_ds("double");
+    fire::io::Data<bool> bool_ds("bool");
+    fire::io::Data<std::string> string_ds("string");
+    fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit");
+    event_header.structure(f);
+    double_ds.structure(f);
+    bool_ds.structure(f);
+    string_ds.structure(f);
+    vector_hit_ds.structure(f);
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      eh.setEventNumber(i_entry);
+      save(event_header,eh,f);
+      save(double_ds,double(i_entry),f);
+      save(bool_ds,i_entry%3==0,f);
+      save(string_ds,std::to_string(i_entry),f);
+      save(vector_hit_ds,all_hits[i_entry%all_hits.size()],f);
+    }
+    fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+    rh_d.structure(f);
+    rh_d.save(f);
+  };
+  std::string threaded_file{"threaded_"+filename}, hdf5_file{"hdf5_"+filename};
+  write(threaded_file, 3, true);
+  write(hdf5_file, 0, false);
+
+  {
+    fire::io::h5::Reader f{threaded_file};
+    fire::io::Data<double> double_ds("double",&f);
+    fire::io::Data<bool> bool_ds("bool",&f);
+    fire::io::Data<std::string> string_ds("string",&f);
+    fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit",&f);
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      BOOST_CHECK(load(double_ds,double(i_entry),f));
+      BOOST_CHECK(load(bool_ds,i_entry%3==0,f));
+      BOOST_CHECK(load(string_ds,std::to_string(i_entry),f));
+      BOOST_CHECK(load(vector_hit_ds,all_hits[i_entry%all_hits.size()],f));
+    }
+  }
+
+  // the chunks we compress are the same bytes as the ones HDF5 compresses
+  auto read_chunk = [](const std::string& name, const std::string& path, hsize_t i_file) {
+    HighFive::File f{name};
+    HighFive::DataSet ds{f.getDataSet(path)};
+    hid_t set{ds.getId()};
+    hsize_t offset[1] = {i_file};
+    hsize_t size;
+    H5Dget_chunk_storage_size(set, offset, &size);
+    std::vector<char> chunk(size);
+    uint32_t filter_mask;
+    H5Dread_chunk(set, H5P_DEFAULT, offset, &filter_mask, chunk.data());
+    return chunk;
+  };
+  for (const std::string path : {"double", "bool", "vector_hit/data/energy"}) {
+    BOOST_TEST_CHECKPOINT("comparing chunks in " << path);
+    BOOST_CHECK(read_chunk(threaded_file, path, 10) == read_chunk(hdf5_file, path, 10));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(chunk_sizes) {
+  static const std::size_t num_entries{200};
+  static const std::string chunked_file{"chunks_"+filename};
+  {
+    fire::config::Parameters output_params;
+    output_params.add<std::string>("name",chunked_file);
+    output_params.add("rows_per_chunk",10000);
+    output_params.add("compression_level", 6);
+    output_params.add("shuffle",false);
+    output_params.add("chunk_bytes",24);
+    output_params.add("chunk_adapt_events",50);
+    fire::io::Writer f{int(num_entries),output_params};
+    fire::EventHeader eh;
+    fire::io::Data<fire::EventHeader> event_header(fire::EventHeader::NAME,nullptr,&eh);
+    fire::io::Data<double> double_ds("double");
+    fire::io::Data<short> rare_ds("rare");
+    fire::io::Data<std::string> string_ds("string");
+    event_header.structure(f);
+    double_ds.structure(f);
+    rare_ds.structure(f);
+    string_ds.structure(f);
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      eh.setEventNumber(i_entry);
+      save(event_header,eh,f);
+      save(double_ds,double(i_entry),f);
+      if (i_entry%100 == 0) save(rare_ds,short(i_entry),f);
+      save(string_ds,std::to_string(i_entry),f);
+      f.nextEvent();
+    }
+    fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+    rh_d.structure(f);
+    rh_d.save(f);
+  }
+
+  auto chunk_length = [](const std::string& path) {
+    HighFive::File f{chunked_file};
+    HighFive::DataSet ds{f.getDataSet(path)};
+    hid_t plist{H5Dget_create_plist(ds.getId())};
+    hsize_t chunk[1] = {0};
+    H5Pget_chunk(plist, 1, chunk);
+    H5Pclose(plist);
+    return chunk[0];
+  };
+  // 24 bytes of doubles
+  BOOST_CHECK_EQUAL(chunk_length("double"), 3);
+  // 1 row in the first 50 events so 4 rows expected by the end,
+  // fewer than the 12 shorts in 24 bytes
+  BOOST_CHECK_EQUAL(chunk_length("rare"), 4);
+  // strings are not sized by bytes, only kept within the 200 expected rows
+  BOOST_CHECK_EQUAL(chunk_length("string"), 200);
+
+  // the reader follows chunks that do not evenly divide its buffer length
+  fire::io::h5::Reader f{chunked_file};
+  fire::io::Data<double> double_ds("double",&f);
+  fire::io::Data<std::string> string_ds("string",&f);
+  for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+    BOOST_CHECK(load(double_ds,double(i_entry),f));
+    BOOST_CHECK(load(string_ds,std::to_string(i_entry),f));
+  }
+  fire::io::Data<short> rare_ds("rare",&f);
+  BOOST_CHECK(load(rare_ds,short(0),f));
+  BOOST_CHECK(load(rare_ds,short(100),f));
+}
+
+BOOST_AUTO_TEST_CASE(memory_budget) {
+  // 150 datasets of 1000-row chunks of doubles is 1.2MB, more than the 1MB budget
+  static const std::size_t num_entries{2500}, num_datasets{150};
+  static const std::string budget_file{"budget_"+filename};
+  {
+    fire::config::Parameters output_params;
+    output_params.add<std::string>("name",budget_file);
+    output_params.add("rows_per_chunk",1000);
+    output_params.add("compression_level", 6);
+    output_params.add("shuffle",false);
+    output_params.add("memory_budget",1);
+    fire::io::Writer f{int(num_entries),output_params};
+    fire::EventHeader eh;
+    fire::io::Data<fire::EventHeader> event_header(fire::EventHeader::NAME,nullptr,&eh);
+    event_header.structure(f);
+    std::vector<std::unique_ptr<fire::io::Data<double>>> datasets;
+    for (std::size_t i{0}; i < num_datasets; i++) {
+      datasets.emplace_back(std::make_unique<fire::io::Data<double>>("double"+std::to_string(i)));
+      datasets.back()->structure(f);
+    }
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      eh.setEventNumber(i_entry);
+      save(event_header,eh,f);
+      for (auto& ds : datasets) save(*ds,double(i_entry),f);
+      f.nextEvent();
+    }
+    fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+    rh_d.structure(f);
+    rh_d.save(f);
+    BOOST_CHECK_GE(f.peakBufferBytes(), num_datasets*1000*sizeof(double));
+  }
+
+  fire::config::Parameters input_params;
+  input_params.add("memory_budget",1);
+  fire::io::h5::Reader f{budget_file,input_params};
+  std::vector<std::unique_ptr<fire::io::Data<double>>> datasets;
+  for (std::size_t i{0}; i < num_datasets; i++) {
+    datasets.emplace_back(std::make_unique<fire::io::Data<double>>("double"+std::to_string(i),&f));
+  }
+  for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+    for (auto& ds : datasets) BOOST_CHECK(load(*ds,double(i_entry),f));
+  }
+  // the buffers cannot shrink below a single chunk each
+  BOOST_CHECK_EQUAL(f.peakBufferBytes(), num_datasets*1000*sizeof(double));
+}
+
+BOOST_AUTO_TEST_CASE(raw_copy) {
+  static const std::size_t num_entries{1000};
+  static const std::string input_file{"raw_input_"+filename};
+  auto params = [](const std::string& name, const std::string& compression) {
+    fire::config::Parameters output_params;
+    output_params.add<std::string>("name",name);
+    output_params.add("rows_per_chunk",100);
+    output_params.add("compression_level", 6);
+    output_params.add("shuffle",true);
+    output_params.add("compression",compression);
+    return output_params;
+  };
+  {
+    fire::io::Writer f{int(num_entries),params(input_file,"deflate")};
+    fire::EventHeader eh;
+    fire::io::Data<fire::EventHeader> event_header(fire::EventHeader::NAME,nullptr,&eh);
+    fire::io::Data<double> double_ds("double");
+    fire::io::Data<bool> bool_ds("bool");
+    fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit");
+    event_header.structure(f);
+    double_ds.structure(f);
+    bool_ds.structure(f);
+    vector_hit_ds.structure(f);
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      eh.setEventNumber(i_entry);
+      save(event_header,eh,f);
+      save(double_ds,double(i_entry),f);
+      save(bool_ds,i_entry%3==0,f);
+      save(vector_hit_ds,all_hits[i_entry%all_hits.size()],f);
+    }
+    fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+    rh_d.structure(f);
+    rh_d.save(f);
+  }
+
+  // same layout copies raw chunks, different layout copies values
+  for (const std::string compression : {"deflate", "none"}) {
+    BOOST_TEST_CHECKPOINT("copying into " << compression);
+    std::string output_file{compression+"_copy_"+filename};
+    {
+      fire::io::h5::Reader reader{input_file};
+      fire::io::Writer writer{int(num_entries),params(output_file,compression)};
+      for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+        for (const std::string& obj : std::vector<std::string>{fire::EventHeader::NAME, "double", "bool", "vector_hit"}) {
+          reader.copy(i_entry, obj, writer);
+        }
+      }
+      fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+      rh_d.structure(writer);
+      rh_d.save(writer);
+    }
+
+    fire::io::h5::Reader f{output_file};
+    fire::io::Data<double> double_ds("double",&f);
+    fire::io::Data<bool> bool_ds("bool",&f);
+    fire::io::Data<std::vector<Hit>> vector_hit_ds("vector_hit",&f);
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      BOOST_CHECK(load(double_ds,double(i_entry),f));
+      BOOST_CHECK(load(bool_ds,i_entry%3==0,f));
+      BOOST_CHECK(load(vector_hit_ds,all_hits[i_entry%all_hits.size()],f));
+    }
+  }
+
+  // the chunks in the copy are the same bytes as the input chunks
+  auto read_chunk = [](const std::string& name, const std::string& path, hsize_t i_file) {
+    HighFive::File f{name};
+    HighFive::DataSet ds{f.getDataSet(path)};
+    hid_t set{ds.getId()};
+    hsize_t offset[1] = {i_file};
+    hsize_t size;
+    H5Dget_chunk_storage_size(set, offset, &size);
+    std::vector<char> chunk(size);
+    uint32_t filter_mask;
+    H5Dread_chunk(set, H5P_DEFAULT, offset, &filter_mask, chunk.data());
+    return chunk;
+  };
+  for (const std::string path : {"double", "bool", "vector_hit/__size__", "vector_hit/data/energy"}) {
+    BOOST_TEST_CHECKPOINT("comparing chunks in " << path);
+    BOOST_CHECK(read_chunk(input_file, path, 100) == read_chunk("deflate_copy_"+filename, path, 100));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(columnar) {
+  // only classes with all atomic members are saved by column
+  BOOST_CHECK(fire::io::Data<Hit>("hit").columnar());
+  BOOST_CHECK(fire::io::Data<DerivedHit>("derived_hit").columnar());
+  BOOST_CHECK(not fire::io::Data<SpecialHit>("special_hit").columnar());
+  BOOST_CHECK(not fire::io::Data<Cluster>("cluster").columnar());
+}
+
+BOOST_AUTO_TEST_CASE(bulk_vector) {
+  static std::string bulk_file{"bulk_"+filename};
+  static const std::size_t num_entries{50};
+  // vectors of varying length, some longer than the chunks
+  auto make_floats = [](std::size_t i_entry) {
+    std::vector<float> floats(i_entry*37);
+    for (std::size_t i{0}; i < floats.size(); i++) floats[i] = i_entry + 0.001*i;
+    return floats;
+  };
+  auto make_strings = [](std::size_t i_entry) {
+    std::vector<std::string> strings(i_entry%4);
+    for (std::size_t i{0}; i < strings.size(); i++) strings[i] = std::to_string(i_entry*i);
+    return strings;
+  };
+  {
+    fire::config::Parameters output_params;
+    output_params.add("name",bulk_file);
+    output_params.add("rows_per_chunk",100);
+    output_params.add("compression_level", 6);
+    output_params.add("shuffle",false);
+    fire::io::Writer f{int(num_entries),output_params};
+
+    fire::EventHeader eh;
+    fire::io::Data<fire::EventHeader> event_header(fire::EventHeader::NAME,nullptr,&eh);
+    fire::io::Data<std::vector<float>> vector_float_ds("vector_float");
+    fire::io::Data<std::vector<std::string>> vector_string_ds("vector_string");
+    event_header.structure(f);
+    vector_float_ds.structure(f);
+    vector_string_ds.structure(f);
+    for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+      eh.setEventNumber(i_entry);
+      BOOST_CHECK(save(event_header,eh,f));
+      BOOST_CHECK(save(vector_float_ds,make_floats(i_entry),f));
+      BOOST_CHECK(save(vector_string_ds,make_strings(i_entry),f));
+    }
+    fire::io::Data<fire::RunHeader> rh_d(fire::io::constants::RUN_HEADER_NAME);
+    rh_d.structure(f);
+    rh_d.save(f);
+  }
+
+  fire::io::h5::Reader f{bulk_file};
+  BOOST_CHECK(f.entries() == num_entries);
+  fire::io::Data<std::vector<float>> vector_float_ds("vector_float",&f);
+  fire::io::Data<std::vector<std::string>> vector_string_ds("vector_string",&f);
+  for (std::size_t i_entry{0}; i_entry < num_entries; i_entry++) {
+    BOOST_CHECK(load(vector_float_ds,make_floats(i_entry),f));
+    BOOST_CHECK(load(vector_string_ds,make_strings(i_entry),f));
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
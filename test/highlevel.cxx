@@ -2,9 +2,14 @@
 #define BOOST_TEST_DYN_LINK
 #include <boost/test/unit_test.hpp>
 
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
 #include <highfive/H5Easy.hpp>
 
 #include "fire/Process.h"
+#include "fire/Workers.h"
 #include "fire/config/Parameters.h"
 
 /**
@@ -106,15 +111,163 @@ class TestGet : public Processor {
   }
 };
 
+/**
+ * only get objects on some of the events
+ * so that lazy loading skips entries
+ */
+class TestSparseGet : public Processor {
+ public:
+  TestSparseGet(const config::Parameters& ps)
+    : Processor(ps) {}
+  ~TestSparseGet() = default;
+  void process(fire::Event& event) final override {
+    if (event.header().number() % 3 == 0) {
+      BOOST_TEST(event.get<int>("keepalong") == event.header().number());
+    }
+    if (event.header().number() % 4 == 1) {
+      BOOST_TEST(event.get<DummyInt>("keepanotherlateget").i == event.header().number());
+    }
+  }
+};
+
+/**
+ * get and add objects through handles, including optional objects
+ * that are only there on some of the events
+ */
+class TestHandles : public Processor {
+  EventHandle<int> keepme_{"keepme"}, async_{"async", "test"},
+                   nothere_{"nothere"}, odd_{"odd"};
+ public:
+  TestHandles(const config::Parameters& ps)
+    : Processor(ps) {}
+  ~TestHandles() = default;
+  void process(fire::Event& event) final override {
+    int n{event.header().number()};
+    BOOST_TEST(event.get(keepme_) == n * 100);
+    BOOST_TEST(event.tryGet(nothere_) == nullptr);
+
+    // input objects are on every event, even if they were cleared
+    const int* async{event.tryGet(async_)};
+    BOOST_REQUIRE(async != nullptr);
+    BOOST_TEST(*async == ((n > 2 and n % 2 == 0) ? n * 1000 : std::numeric_limits<int>::min()));
+
+    // searches are remembered and pick up the objects that became available
+    BOOST_TEST(event.search("keep.*", "test", "").size() == 4);
+    BOOST_TEST(event.search("^odd$", "", "").size() == (n == 1 ? 0 : 1));
+    BOOST_TEST(event.exists("odd") == (n != 1));
+
+    // objects created during processing are only there when they are added
+    BOOST_TEST(event.tryGet(odd_) == nullptr);
+    if (n % 2 == 1) {
+      event.add(odd_, n);
+      BOOST_TEST(event.search("^odd$", "", "").size() == 1);
+      BOOST_TEST(event.exists("odd", "handles"));
+      // the name and pass can still be patterns, as long as they match a single object
+      BOOST_TEST(event.exists("odd", ".*"));
+      BOOST_TEST(event.exists("o.d", "hand.*"));
+      BOOST_TEST(not event.exists("keep.*", "test"));
+      // searching past the limit of remembered searches starts them over
+      for (int i{0}; i < 300; i++) event.search("^odd" + std::to_string(i) + "$", "", "");
+      BOOST_TEST(event.search("^odd$", "", "").size() == 1);
+      BOOST_TEST(*event.tryGet(odd_) == n);
+      BOOST_TEST(event.get(odd_) == n);
+      BOOST_CHECK_THROW(event.add(odd_, n), fire::Exception);
+    }
+  }
+};
+
+/**
+ * add objects on some of the events and read a kept object late
+ * so that the events in flight on other threads need to catch up
+ *
+ * No checks are done here since the checks are not thread safe,
+ * the output file is checked afterwards.
+ */
+class TestThreads : public Processor {
+ public:
+  TestThreads(const config::Parameters& ps)
+    : Processor(ps) {}
+  ~TestThreads() = default;
+  void process(fire::Event& event) final override {
+    if (event.header().number() % 2 == 0) {
+      event.add("twice", event.get<int>("keepme")*2);
+    }
+    if (event.header().number() > 4) {
+      event.add("late", event.get<int>("keeplateget"));
+    }
+  }
+};
+
+/**
+ * the same as TestThreads but getting and adding the objects through handles
+ */
+class TestThreadsHandles : public Processor {
+  EventHandle<int> keepme_{"keepme"}, keeplateget_{"keeplateget"},
+                   twice_{"twice"}, late_{"late"};
+ public:
+  TestThreadsHandles(const config::Parameters& ps)
+    : Processor(ps) {}
+  ~TestThreadsHandles() = default;
+  void process(fire::Event& event) final override {
+    if (event.header().number() % 2 == 0) {
+      event.add(twice_, event.get(keepme_)*2);
+    }
+    if (event.header().number() > 4) {
+      event.add(late_, event.get(keeplateget_));
+    }
+  }
+};
+
+/**
+ * Vote to keep the events with an even number
+ */
+class TestVote : public Processor {
+ public:
+  TestVote(const config::Parameters& ps)
+    : Processor(ps) {}
+  ~TestVote() = default;
+  void process(fire::Event& event) final override {
+    if (event.header().number() % 2 == 0) setStorageHint(StorageControl::Hint::ShouldKeep);
+  }
+};
+
+/**
+ * Scale one integer object into another, declaring the objects
+ * through the Processor API so it can be run at once with others
+ */
+class TestScale : public Processor {
+  std::string input_, output_;
+  int factor_;
+ public:
+  TestScale(const config::Parameters& ps)
+    : Processor(ps),
+      input_{ps.get<std::string>("input")},
+      output_{ps.get<std::string>("output")},
+      factor_{ps.get<int>("factor")} {
+    consumes(input_);
+    produces(output_);
+  }
+  ~TestScale() = default;
+  void process(fire::Event& event) final override {
+    event.add(output_, event.get<int>(input_)*factor_);
+  }
+};
+
 }
 
 /**
- * Cannot use macro because two processors are
+ * Cannot use macro because several processors are
  * in the same compilation unit.
  */
 namespace {
   auto v0 = ::fire::Processor::Factory::get().declare<fire::test::TestAdd>();
   auto v1 = ::fire::Processor::Factory::get().declare<fire::test::TestGet>();
+  auto v2 = ::fire::Processor::Factory::get().declare<fire::test::TestSparseGet>();
+  auto v3 = ::fire::Processor::Factory::get().declare<fire::test::TestThreads>();
+  auto v4 = ::fire::Processor::Factory::get().declare<fire::test::TestScale>();
+  auto v5 = ::fire::Processor::Factory::get().declare<fire::test::TestVote>();
+  auto v6 = ::fire::Processor::Factory::get().declare<fire::test::TestHandles>();
+  auto v7 = ::fire::Processor::Factory::get().declare<fire::test::TestThreadsHandles>();
 }
 
 /**
@@ -247,4 +400,666 @@ BOOST_AUTO_TEST_CASE(recon_drop_async, *boost::unit_test::depends_on("highlevel/
   BOOST_TEST(not f.exist(pass_grp+"/dropalong"));
 }
 
+BOOST_AUTO_TEST_CASE(recon_lazy, *boost::unit_test::depends_on("highlevel/prod_drop_async")) {
+  std::string output{"recon_lazy.h5"},
+              pass{"test"};
+  fire::config::Parameters configuration;
+  configuration.add("pass_name",pass);
+  configuration.add("lazy_load",true);
+
+  fire::config::Parameters output_file;
+  output_file.add("name", output);
+  output_file.add("event_limit", 10);
+  output_file.add("rows_per_chunk", 1000);
+  output_file.add("compression_level", 6);
+  output_file.add("shuffle",false);
+  configuration.add("output_file",output_file);
+
+  std::vector<std::string> input_files = { "prod_drop_async.h5" };
+  configuration.add("input_files",input_files );
+  
+  fire::config::Parameters storage;
+  storage.add("default_keep",true);
+  configuration.add("storage",storage);
+
+  // keep keepme while it is never accessed and keepalong while it is
+  // only accessed on some events, drop the other sparsely accessed object
+  fire::config::Parameters keep_rule, drop_rule;
+  keep_rule.add<std::string>("regex",".*/keep.*");
+  keep_rule.add("keep",true);
+  drop_rule.add<std::string>("regex",".*/keepanotherlateget");
+  drop_rule.add("keep",false);
+  configuration.add<std::vector<fire::config::Parameters>>("drop_keep_rules", {keep_rule, drop_rule});
+
+  configuration.add("event_limit", -1);
+  configuration.add("log_frequency", -1);
+
+  configuration.add("run", 1); // not used for recon mode
+  configuration.add("max_tries", 1); // not used in recon mode
+
+  fire::config::Parameters test_get;
+  test_get.add<std::string>("name","test_sparse_get");
+  test_get.add<std::string>("class_name","fire::test::TestSparseGet");
+
+  configuration.add<std::vector<fire::config::Parameters>>("sequence", {test_get});
+  configuration.add<fire::config::Parameters>("conditions",{});
+
+  try {
+    fire::Process p(configuration);
+    p.run();
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    BOOST_TEST(false);
+  }
+
+  std::vector<int> correct = {
+    1,2,3,4,5,6,7,8,9,10
+  };
+  std::vector<int> keepme_correct = {
+    100,200,300,400,500,600,700,800,900,1000
+  };
+
+  H5Easy::File f(output);
+  std::string pass_grp{fire::io::constants::EVENT_GROUP+"/"+pass};
+  BOOST_TEST(H5Easy::load<std::vector<int>>(f, pass_grp+"/keepme") == keepme_correct);
+  BOOST_TEST(H5Easy::load<std::vector<int>>(f, pass_grp+"/keepalong") == correct);
+  BOOST_TEST(not f.exist(pass_grp+"/keepanotherlateget"));
+}
+
+/**
+ * Configure reconstructing the prod_drop_async events with TestHandles
+ *
+ * @param[in] output name of output file
+ * @param[in] rows_per_chunk number of rows in each chunk of the output file
+ * @return configuration ready for other options to be added
+ */
+fire::config::Parameters reconHandles(const std::string& output, int rows_per_chunk = 1000) {
+  fire::config::Parameters configuration;
+  configuration.add("pass_name",std::string("handles"));
+  configuration.add("lazy_load",true);
+
+  fire::config::Parameters output_file;
+  output_file.add("name", output);
+  output_file.add("event_limit", 10);
+  output_file.add("rows_per_chunk", rows_per_chunk);
+  output_file.add("compression_level", 6);
+  output_file.add("shuffle",false);
+  configuration.add("output_file",output_file);
+
+  std::vector<std::string> input_files = { "prod_drop_async.h5" };
+  configuration.add("input_files",input_files );
+  
+  fire::config::Parameters storage;
+  storage.add("default_keep",true);
+  configuration.add("storage",storage);
+
+  configuration.add("event_limit", -1);
+  configuration.add("log_frequency", -1);
+
+  configuration.add("run", 1); // not used for recon mode
+  configuration.add("max_tries", 1); // not used in recon mode
+
+  fire::config::Parameters test_handles;
+  test_handles.add<std::string>("name","test_handles");
+  test_handles.add<std::string>("class_name","fire::test::TestHandles");
+
+  configuration.add<std::vector<fire::config::Parameters>>("sequence", {test_handles});
+  configuration.add<fire::config::Parameters>("conditions",{});
+  return configuration;
+}
+
+/**
+ * Run a process, failing the test if it throws
+ *
+ * @param[in] configuration configuration of process
+ */
+void runProcess(const fire::config::Parameters& configuration) {
+  try {
+    fire::Process p(configuration);
+    p.run();
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    BOOST_TEST(false);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(recon_handles, *boost::unit_test::depends_on("highlevel/prod_drop_async")) {
+  std::string output{"recon_handles.h5"};
+  runProcess(reconHandles(output));
+
+  static const int cleared{std::numeric_limits<int>::min()};
+  std::vector<int> odd_correct = {1,cleared,3,cleared,5,cleared,7,cleared,9,cleared};
+
+  H5Easy::File f(output);
+  BOOST_TEST(H5Easy::load<std::vector<int>>(f, fire::io::constants::EVENT_GROUP+"/handles/odd") == odd_correct);
+}
+
+BOOST_AUTO_TEST_CASE(recon_prefix_rules, *boost::unit_test::depends_on("highlevel/prod_drop_async")) {
+  std::string output{"recon_prefix_rules.h5"};
+  auto configuration{reconHandles(output)};
+
+  // rules starting with literal text ignoring case, the second starts
+  // like the name of odd but does not match all of it
+  fire::config::Parameters keep_rule, drop_rule;
+  keep_rule.add<std::string>("regex","Test/KeepM[a-z]");
+  keep_rule.add("keep",true);
+  drop_rule.add<std::string>("regex","handles/odd.+");
+  drop_rule.add("keep",false);
+  configuration.add<std::vector<fire::config::Parameters>>("drop_keep_rules", {keep_rule, drop_rule});
+
+  runProcess(configuration);
+
+  std::vector<int> keepme_correct = {100,200,300,400,500,600,700,800,900,1000};
+
+  H5Easy::File f(output);
+  BOOST_TEST(f.exist(fire::io::constants::EVENT_GROUP+"/handles/odd"));
+  BOOST_TEST(H5Easy::load<std::vector<int>>(f, fire::io::constants::EVENT_GROUP+"/test/keepme") == keepme_correct);
+  BOOST_TEST(not f.exist(fire::io::constants::EVENT_GROUP+"/test/keepalong"));
+}
+
+BOOST_AUTO_TEST_CASE(recon_timing, *boost::unit_test::depends_on("highlevel/prod_drop_async")) {
+  std::string output{"recon_timing.h5"};
+  // small chunks so the output is written to disk while processing
+  auto configuration{reconHandles(output, 2)};
+  configuration.add("timing",true);
+  runProcess(configuration);
+
+  // the timing table has a row for each timer
+  H5Easy::File f(output);
+  auto timers{H5Easy::load<std::vector<std::string>>(f, fire::Timing::NAME+"/name")};
+  auto calls{H5Easy::load<std::vector<long int>>(f, fire::Timing::NAME+"/calls")};
+  auto wall{H5Easy::load<std::vector<double>>(f, fire::Timing::NAME+"/wall")};
+  auto p50{H5Easy::load<std::vector<double>>(f, fire::Timing::NAME+"/p50")};
+  auto max{H5Easy::load<std::vector<double>>(f, fire::Timing::NAME+"/max")};
+  BOOST_REQUIRE(timers.size() == 6);
+  BOOST_REQUIRE(calls.size() == 6);
+  BOOST_TEST(timers.at(0) == "test_handles::process");
+  BOOST_TEST(calls.at(0) == 10);
+  BOOST_TEST(timers.at(3) == "Event::load");
+  BOOST_TEST(calls.at(3) == 10);
+  BOOST_TEST(timers.at(4) == "Event::save");
+  BOOST_TEST(calls.at(4) == 10);
+  // each of the five chunks of the event header is written on its own
+  BOOST_TEST(timers.at(5) == "Writer::flush");
+  BOOST_TEST(calls.at(5) >= 5);
+  for (std::size_t i{0}; i < timers.size(); i++) {
+    BOOST_TEST(p50.at(i) <= max.at(i));
+    BOOST_TEST(max.at(i) <= wall.at(i));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(recon_counters, *boost::unit_test::depends_on("highlevel/prod_drop_async")) {
+  std::string output{"recon_counters.h5"};
+  // counting enables the timing as well
+  auto configuration{reconHandles(output)};
+  configuration.add("counters",true);
+  runProcess(configuration);
+
+  H5Easy::File f(output);
+  // the hardware counters may not be permitted, but the software ones always are
+  auto timers{H5Easy::load<std::vector<std::string>>(f, fire::Timing::NAME+"/name")};
+  auto cycles{H5Easy::load<std::vector<long int>>(f, fire::Timing::NAME+"/cycles")};
+  auto instructions{H5Easy::load<std::vector<long int>>(f, fire::Timing::NAME+"/instructions")};
+  auto faults{H5Easy::load<std::vector<long int>>(f, fire::Timing::NAME+"/page_faults")};
+  auto switches{H5Easy::load<std::vector<long int>>(f, fire::Timing::NAME+"/context_switches")};
+  BOOST_REQUIRE(cycles.size() == 6);
+  BOOST_TEST((cycles.at(0) == -1) == (instructions.at(0) == -1));
+  BOOST_TEST((cycles.at(0) == -1 or instructions.at(0) > 0));
+  for (std::size_t i{0}; i < timers.size(); i++) {
+    BOOST_TEST(faults.at(i) >= 0);
+    BOOST_TEST(switches.at(i) >= 0);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(recon_trace, *boost::unit_test::depends_on("highlevel/prod_drop_async")) {
+  auto configuration{reconHandles("recon_trace.h5")};
+  configuration.add<std::string>("trace_file","recon_trace.json");
+  configuration.add("trace_every",3);
+  runProcess(configuration);
+
+  // events 0, 3, 6, and 9 are traced along with all of the disk operations
+  std::stringstream trace;
+  trace << std::ifstream("recon_trace.json").rdbuf();
+  auto count = [&trace](const std::string& name) {
+    std::string s{trace.str()}, span{"{\"name\":\""+name+"\","};
+    std::size_t n{0};
+    for (auto pos{s.find(span)}; pos != std::string::npos; pos = s.find(span, pos+1)) n++;
+    return n;
+  };
+  BOOST_TEST(trace.str().rfind("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", 0) == 0);
+  BOOST_TEST(count("event") == 4);
+  BOOST_TEST(count("test_handles") == 4);
+  BOOST_TEST(count("Event::load") == 4);
+  BOOST_TEST(count("Process::openInput") == 1);
+  BOOST_TEST(count("Process::closeInput") == 1);
+  BOOST_TEST(count("Writer::write") > 0);
+  BOOST_TEST(count("h5::Reader::Buffer::load") > 0);
+
+  // the spans are written to the file as they finish, not only when it is closed
+  fire::io::Trace::open("recon_trace_stream.json", 1);
+  for (std::size_t i{0}; i < fire::io::Trace::FLUSH_RECORDS; i++) {
+    fire::io::Trace::Span span{"stream", "test"};
+  }
+  BOOST_TEST(std::filesystem::file_size("recon_trace_stream.json") > 50*fire::io::Trace::FLUSH_RECORDS);
+  fire::io::Trace::close();
+}
+
+BOOST_AUTO_TEST_CASE(prod_threads) {
+  std::string output{"prod_threads.h5"};
+  fire::config::Parameters configuration;
+  configuration.add("pass_name",std::string("test"));
+  configuration.add("threads",3);
+
+  fire::config::Parameters output_file;
+  output_file.add("name", output);
+  output_file.add("event_limit", 10);
+  output_file.add("rows_per_chunk", 1000);
+  output_file.add("compression_level", 6);
+  output_file.add("shuffle",false);
+  configuration.add("output_file",output_file);
+  
+  fire::config::Parameters dk_rule;
+  dk_rule.add<std::string>("regex",".*/drop.*");
+  dk_rule.add("keep",false);
+  configuration.add<std::vector<fire::config::Parameters>>("drop_keep_rules", {dk_rule});
+  
+  fire::config::Parameters storage;
+  storage.add("default_keep",true);
+  configuration.add("storage",storage);
+
+  configuration.add("event_limit", 10);
+  configuration.add("log_frequency", -1);
+
+  configuration.add("run", 1);
+  configuration.add("max_tries", 1);
+
+  fire::config::Parameters test_add;
+  test_add.add<std::string>("name","test_add");
+  test_add.add<std::string>("class_name","fire::test::TestAdd");
+
+  configuration.add<std::vector<fire::config::Parameters>>("sequence", {test_add});
+  configuration.add<fire::config::Parameters>("conditions",{});
+
+  try {
+    fire::Process p(configuration);
+    p.run();
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    BOOST_TEST(false);
+  }
+
+  // the events are saved in order with the asynchronously added
+  // objects lined up with the events they were added in
+  std::vector<int> correct = {1,2,3,4,5,6,7,8,9,10};
+  std::vector<int> keepme_correct = {100,200,300,400,500,600,700,800,900,1000};
+  static const int cleared{std::numeric_limits<int>::min()};
+  std::vector<int> async_correct = {cleared,cleared,cleared,4000,cleared,6000,cleared,8000,cleared,10000};
+
+  H5Easy::File f(output);
+  std::string pass_grp{fire::io::constants::EVENT_GROUP+"/test"};
+  BOOST_TEST(H5Easy::load<std::vector<int>>(f, fire::EventHeader::NAME+"/number") == correct);
+  BOOST_TEST(H5Easy::load<std::vector<int>>(f, pass_grp+"/keepme") == keepme_correct);
+  BOOST_TEST(H5Easy::load<std::vector<int>>(f, pass_grp+"/keepalong") == correct);
+  BOOST_TEST(H5Easy::load<std::vector<int>>(f, pass_grp+"/async") == async_correct);
+  BOOST_TEST(not f.exist(pass_grp+"/dropme"));
+}
+
+BOOST_AUTO_TEST_CASE(recon_threads, *boost::unit_test::depends_on("highlevel/prod_threads")) {
+  struct Mode {
+    std::string output;
+    int threads;
+    bool ordered, pipeline;
+    std::string processor;
+  };
+  for (const auto& [output, threads, ordered, pipeline, processor] : {
+         Mode{"recon_threads.h5", 3, true, false, "TestThreads"},
+         Mode{"recon_threads_unordered.h5", 3, false, false, "TestThreads"},
+         Mode{"recon_pipeline.h5", 1, true, true, "TestThreads"},
+         Mode{"recon_pipeline_threads.h5", 3, false, true, "TestThreads"},
+         Mode{"recon_threads_handles.h5", 3, false, false, "TestThreadsHandles"},
+         Mode{"recon_pipeline_handles.h5", 3, false, true, "TestThreadsHandles"}}) {
+    BOOST_TEST_CHECKPOINT(output);
+    fire::config::Parameters configuration;
+    configuration.add("pass_name",std::string("threads"));
+    configuration.add("threads",threads);
+    configuration.add("ordered_output",ordered);
+    configuration.add("pipeline",pipeline);
+
+    fire::config::Parameters output_file;
+    output_file.add("name", output);
+    output_file.add("event_limit", 10);
+    output_file.add("rows_per_chunk", 1000);
+    output_file.add("compression_level", 6);
+    output_file.add("shuffle",false);
+    configuration.add("output_file",output_file);
+
+    std::vector<std::string> input_files = { "prod_threads.h5" };
+    configuration.add("input_files",input_files );
+
+    fire::config::Parameters dk_rule;
+    dk_rule.add<std::string>("regex",".*/keep.*");
+    dk_rule.add("keep",true);
+    configuration.add<std::vector<fire::config::Parameters>>("drop_keep_rules", {dk_rule});
+
+    fire::config::Parameters storage;
+    storage.add("default_keep",true);
+    configuration.add("storage",storage);
+
+    configuration.add("event_limit", -1);
+    configuration.add("log_frequency", -1);
+
+    configuration.add("run", 1); // not used for recon mode
+    configuration.add("max_tries", 1); // not used in recon mode
+
+    fire::config::Parameters test_threads;
+    test_threads.add<std::string>("name","test_threads");
+    test_threads.add<std::string>("class_name","fire::test::"+processor);
+
+    configuration.add<std::vector<fire::config::Parameters>>("sequence", {test_threads});
+    configuration.add<fire::config::Parameters>("conditions",{});
+
+    try {
+      fire::Process p(configuration);
+      p.run();
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      BOOST_TEST(false);
+    }
+
+    // each row of the output needs to line up with its event
+    H5Easy::File f(output);
+    auto numbers{H5Easy::load<std::vector<int>>(f, fire::EventHeader::NAME+"/number")};
+    auto keepme{H5Easy::load<std::vector<int>>(f, "events/test/keepme")};
+    auto keeplateget{H5Easy::load<std::vector<int>>(f, "events/test/keeplateget")};
+    auto twice{H5Easy::load<std::vector<int>>(f, "events/threads/twice")};
+    auto late{H5Easy::load<std::vector<int>>(f, "events/threads/late")};
+    BOOST_REQUIRE(numbers.size() == 10);
+    BOOST_REQUIRE(keepme.size() == 10);
+    BOOST_REQUIRE(keeplateget.size() == 10);
+    BOOST_REQUIRE(twice.size() == 10);
+    BOOST_REQUIRE(late.size() == 10);
+    static const int cleared{std::numeric_limits<int>::min()};
+    for (std::size_t i{0}; i < numbers.size(); i++) {
+      int n{numbers.at(i)};
+      if (ordered) BOOST_TEST(n == i+1);
+      BOOST_TEST(keepme.at(i) == 100*n);
+      BOOST_TEST(keeplateget.at(i) == n);
+      BOOST_TEST(twice.at(i) == (n % 2 == 0 ? 200*n : cleared));
+      BOOST_TEST(late.at(i) == (n > 4 ? n : cleared));
+    }
+    std::sort(numbers.begin(), numbers.end());
+    BOOST_TEST(numbers == std::vector<int>({1,2,3,4,5,6,7,8,9,10}));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(recon_concurrent, *boost::unit_test::depends_on("highlevel/prod_threads")) {
+  std::string output{"recon_concurrent.h5"};
+  fire::config::Parameters configuration;
+  configuration.add("pass_name",std::string("concurrent"));
+  configuration.add("threads",2);
+  configuration.add("processor_threads",3);
+
+  fire::config::Parameters output_file;
+  output_file.add("name", output);
+  output_file.add("event_limit", 10);
+  output_file.add("rows_per_chunk", 1000);
+  output_file.add("compression_level", 6);
+  output_file.add("shuffle",false);
+  configuration.add("output_file",output_file);
+
+  std::vector<std::string> input_files = { "prod_threads.h5" };
+  configuration.add("input_files",input_files );
+
+  fire::config::Parameters storage;
+  storage.add("default_keep",true);
+  configuration.add("storage",storage);
+
+  configuration.add("event_limit", -1);
+  configuration.add("log_frequency", -1);
+  configuration.add("run", 1); // not used for recon mode
+  configuration.add("max_tries", 1); // not used in recon mode
+
+  auto scale = [](const std::string& name, const std::string& input,
+                  const std::string& output, int factor) {
+    fire::config::Parameters ps;
+    ps.add("name",name);
+    ps.add<std::string>("class_name","fire::test::TestScale");
+    ps.add("input",input);
+    ps.add("output",output);
+    ps.add("factor",factor);
+    return ps;
+  };
+
+  // declared through the configuration instead of the Processor API
+  fire::config::Parameters test_threads;
+  test_threads.add<std::string>("name","test_threads");
+  test_threads.add<std::string>("class_name","fire::test::TestThreads");
+  test_threads.add<std::vector<std::string>>("consumes", {"keepme","keeplateget"});
+  test_threads.add<std::vector<std::string>>("produces", {"twice","late"});
+
+  // 'a' and 'b' are independent, 'c' needs 'a', 'd' needs 'b', and 'e' needs 'c'
+  configuration.add<std::vector<fire::config::Parameters>>("sequence", {
+      scale("a","keepme","a",2),
+      scale("b","keepme","b",3),
+      test_threads,
+      scale("c","a","c",5),
+      scale("d","b","d",7),
+      scale("e","c","d2",1)});
+  configuration.add<fire::config::Parameters>("conditions",{});
+
+  try {
+    fire::Process p(configuration);
+    p.run();
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    BOOST_TEST(false);
+  }
+
+  H5Easy::File f(output);
+  auto numbers{H5Easy::load<std::vector<int>>(f, fire::EventHeader::NAME+"/number")};
+  auto a{H5Easy::load<std::vector<int>>(f, "events/concurrent/a")};
+  auto b{H5Easy::load<std::vector<int>>(f, "events/concurrent/b")};
+  auto c{H5Easy::load<std::vector<int>>(f, "events/concurrent/c")};
+  auto d{H5Easy::load<std::vector<int>>(f, "events/concurrent/d")};
+  auto d2{H5Easy::load<std::vector<int>>(f, "events/concurrent/d2")};
+  auto twice{H5Easy::load<std::vector<int>>(f, "events/concurrent/twice")};
+  BOOST_REQUIRE(numbers.size() == 10);
+  static const int cleared{std::numeric_limits<int>::min()};
+  for (std::size_t i{0}; i < numbers.size(); i++) {
+    int n{numbers.at(i)};
+    BOOST_TEST(n == i+1);
+    BOOST_TEST(a.at(i) == 200*n);
+    BOOST_TEST(b.at(i) == 300*n);
+    BOOST_TEST(c.at(i) == 1000*n);
+    BOOST_TEST(d.at(i) == 2100*n);
+    BOOST_TEST(d2.at(i) == 1000*n);
+    BOOST_TEST(twice.at(i) == (n % 2 == 0 ? 200*n : cleared));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(recon_window, *boost::unit_test::depends_on("highlevel/prod_threads")) {
+  // the objects are got and added by name and through handles
+  for (const std::string processor : {"TestThreads", "TestThreadsHandles"}) {
+    std::string output{processor == "TestThreads" ? "recon_window.h5" : "recon_window_handles.h5"};
+    BOOST_TEST_CHECKPOINT(output);
+    fire::config::Parameters configuration;
+    configuration.add("pass_name",std::string("window"));
+
+    fire::config::Parameters output_file;
+    output_file.add("name", output);
+    output_file.add("event_limit", 10);
+    output_file.add("rows_per_chunk", 1000);
+    output_file.add("compression_level", 6);
+    output_file.add("shuffle",false);
+    configuration.add("output_file",output_file);
+
+    // the window starts in the first file and ends in the second
+    std::vector<std::string> input_files = { "prod_threads.h5", "prod_threads.h5" };
+    configuration.add("input_files",input_files );
+    configuration.add("first_entry", 7);
+    configuration.add("last_entry", 13);
+
+    fire::config::Parameters dk_rule;
+    dk_rule.add<std::string>("regex",".*/keep.*");
+    dk_rule.add("keep",true);
+    configuration.add<std::vector<fire::config::Parameters>>("drop_keep_rules", {dk_rule});
+
+    fire::config::Parameters storage;
+    storage.add("default_keep",true);
+    configuration.add("storage",storage);
+
+    configuration.add("event_limit", -1);
+    configuration.add("log_frequency", -1);
+    configuration.add("run", 1); // not used for recon mode
+    configuration.add("max_tries", 1); // not used in recon mode
+
+    fire::config::Parameters test_threads;
+    test_threads.add<std::string>("name","test_threads");
+    test_threads.add<std::string>("class_name","fire::test::"+processor);
+    configuration.add<std::vector<fire::config::Parameters>>("sequence", {test_threads});
+    configuration.add<fire::config::Parameters>("conditions",{});
+
+    {
+      fire::Process p(configuration);
+      BOOST_CHECK_NO_THROW(p.run());
+    }
+
+    {
+      H5Easy::File f(output);
+      auto numbers{H5Easy::load<std::vector<int>>(f, fire::EventHeader::NAME+"/number")};
+      auto keepme{H5Easy::load<std::vector<int>>(f, "events/test/keepme")};
+      BOOST_TEST(numbers == std::vector<int>({8,9,10,1,2,3}));
+      BOOST_REQUIRE(keepme.size() == numbers.size());
+      for (std::size_t i{0}; i < numbers.size(); i++) BOOST_TEST(keepme.at(i) == 100*numbers.at(i));
+    }
+
+    // an entry window that ends before it starts
+    configuration.set("first_entry", 5);
+    configuration.set("last_entry", 2);
+    fire::Process p(configuration);
+    BOOST_CHECK_THROW(p.run(), fire::Exception);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(recon_workers, *boost::unit_test::depends_on("highlevel/prod_threads")) {
+  // the objects are got and added by name and through handles
+  for (const std::string processor : {"TestThreads", "TestThreadsHandles"}) {
+    std::string stem{processor == "TestThreads" ? "recon_workers" : "recon_workers_handles"},
+                output{stem + ".h5"};
+    BOOST_TEST_CHECKPOINT(output);
+    fire::config::Parameters configuration;
+    configuration.add("pass_name",std::string("workers"));
+
+    fire::config::Parameters output_file;
+    output_file.add("name", output);
+    output_file.add("event_limit", 10);
+    output_file.add("rows_per_chunk", 1000);
+    output_file.add("compression_level", 6);
+    output_file.add("shuffle",false);
+    configuration.add("output_file",output_file);
+
+    // the same file twice so the workers see more than one file
+    std::vector<std::string> input_files = { "prod_threads.h5", "prod_threads.h5" };
+    configuration.add("input_files",input_files );
+
+    fire::config::Parameters dk_rule;
+    dk_rule.add<std::string>("regex",".*/keep.*");
+    dk_rule.add("keep",true);
+    configuration.add<std::vector<fire::config::Parameters>>("drop_keep_rules", {dk_rule});
+
+    fire::config::Parameters storage;
+    storage.add("default_keep",true);
+    configuration.add("storage",storage);
+
+    configuration.add("event_limit", 15);
+    configuration.add("log_frequency", -1);
+    configuration.add("run", 1); // not used for recon mode
+    configuration.add("max_tries", 1); // not used in recon mode
+
+    fire::config::Parameters test_threads;
+    test_threads.add<std::string>("name","test_threads");
+    test_threads.add<std::string>("class_name","fire::test::"+processor);
+    configuration.add<std::vector<fire::config::Parameters>>("sequence", {test_threads});
+    configuration.add<fire::config::Parameters>("conditions",{});
+
+    try {
+      fire::runWorkers(configuration, 3);
+    } catch (const std::exception& e) {
+      std::cerr << e.what() << std::endl;
+      BOOST_TEST(false);
+    }
+
+    // the partial outputs are merged and then removed
+    for (int i_worker{0}; i_worker < 3; i_worker++)
+      BOOST_TEST(not std::filesystem::exists(stem+"_worker"+std::to_string(i_worker)+".h5"));
+
+    // each row needs to line up with its event, but they are out of order
+    H5Easy::File f(output);
+    auto numbers{H5Easy::load<std::vector<int>>(f, fire::EventHeader::NAME+"/number")};
+    auto keepme{H5Easy::load<std::vector<int>>(f, "events/test/keepme")};
+    auto twice{H5Easy::load<std::vector<int>>(f, "events/workers/twice")};
+    auto runs{H5Easy::load<std::vector<int>>(f, fire::RunHeader::NAME+"/number")};
+    BOOST_REQUIRE(numbers.size() == 15);
+    BOOST_REQUIRE(keepme.size() == 15);
+    BOOST_REQUIRE(twice.size() == 15);
+    static const int cleared{std::numeric_limits<int>::min()};
+    for (std::size_t i{0}; i < numbers.size(); i++) {
+      int n{numbers.at(i)};
+      BOOST_TEST(keepme.at(i) == 100*n);
+      BOOST_TEST(twice.at(i) == (n % 2 == 0 ? 200*n : cleared));
+    }
+    std::sort(numbers.begin(), numbers.end());
+    BOOST_TEST(numbers == std::vector<int>({1,1,2,2,3,3,4,4,5,5,6,7,8,9,10}));
+    BOOST_TEST(runs == std::vector<int>({1}));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(recon_workers_vote, *boost::unit_test::depends_on("highlevel/prod_threads")) {
+  std::string output{"recon_workers_vote.h5"};
+  fire::config::Parameters configuration;
+  configuration.add("pass_name",std::string("vote"));
+
+  fire::config::Parameters output_file;
+  output_file.add("name", output);
+  output_file.add("event_limit", 10);
+  output_file.add("rows_per_chunk", 1000);
+  output_file.add("compression_level", 6);
+  output_file.add("shuffle",false);
+  configuration.add("output_file",output_file);
+
+  std::vector<std::string> input_files = { "prod_threads.h5" };
+  configuration.add("input_files",input_files );
+
+  // only the events the workers vote to keep are kept
+  fire::config::Parameters storage, listen_all;
+  listen_all.add<std::string>("processor",".*");
+  listen_all.add<std::string>("purpose",".*");
+  storage.add("default_keep",false);
+  storage.add<std::vector<fire::config::Parameters>>("listening_rules",{listen_all});
+  configuration.add("storage",storage);
+
+  configuration.add("event_limit", -1);
+  configuration.add("log_frequency", -1);
+  configuration.add("run", 1); // not used for recon mode
+  configuration.add("max_tries", 1); // not used in recon mode
+
+  fire::config::Parameters test_vote;
+  test_vote.add<std::string>("name","test_vote");
+  test_vote.add<std::string>("class_name","fire::test::TestVote");
+  configuration.add<std::vector<fire::config::Parameters>>("sequence", {test_vote});
+  configuration.add<fire::config::Parameters>("conditions",{});
+
+  try {
+    fire::runWorkers(configuration, 3);
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    BOOST_TEST(false);
+  }
+
+  H5Easy::File f(output);
+  auto numbers{H5Easy::load<std::vector<int>>(f, fire::EventHeader::NAME+"/number")};
+  std::sort(numbers.begin(), numbers.end());
+  BOOST_TEST(numbers == std::vector<int>({2,4,6,8,10}));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+/**
+ * @file AtomicOverhead.cxx
+ * Microbenchmark of the per-value overhead of saving and loading atomic types
+ *
+ * We compare looking up the Buffer by its path for every value
+ * (io::Writer::save and io::h5::Reader::load) with going through
+ * io::Data which looks up its Buffer once and keeps a handle to it.
+ * Each event saves one value to each of several members so that
+ * the path lookup sees a realistic number of datasets.
+ *
+ * Usage: fire-bench-atomic [num_events] [num_members]
+ */
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "fire/io/Data.h"
+
+namespace {
+
+/// the number of nanoseconds per value since the input start
+double ns_per_value(std::chrono::steady_clock::time_point start,
+                    std::size_t num_values) {
+  std::chrono::duration<double, std::nano> elapsed{
+      std::chrono::steady_clock::now() - start};
+  return elapsed.count() / num_values;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::size_t num_events{argc > 1 ? std::stoul(argv[1]) : 1000000ul};
+  std::size_t num_members{argc > 2 ? std::stoul(argv[2]) : 10ul};
+  std::size_t num_values{num_events * num_members};
+  static const std::string file_name{"atomic_overhead.h5"};
+  static const std::string by_path{fire::io::constants::EVENT_GROUP + "/bench/by_path/member"};
+  static const std::string by_data{fire::io::constants::EVENT_GROUP + "/bench/by_data/member"};
+
+  std::vector<std::string> path_members;
+  for (std::size_t i{0}; i < num_members; i++)
+    path_members.push_back(by_path + std::to_string(i));
+
+  {
+    fire::config::Parameters ps;
+    ps.add<std::string>("name", file_name);
+    ps.add("rows_per_chunk", 10000);
+    ps.add("compression_level", 0);
+    ps.add("shuffle", false);
+    fire::io::Writer f{int(num_events), ps};
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i_event{0}; i_event < num_events; i_event++) {
+      for (const auto& path : path_members) f.save(path, float(i_event));
+    }
+    std::cout << "save by path : " << ns_per_value(start, num_values) << " ns/value" << std::endl;
+
+    std::vector<std::unique_ptr<fire::io::Data<float>>> data_members;
+    for (std::size_t i{0}; i < num_members; i++) {
+      data_members.emplace_back(
+          std::make_unique<fire::io::Data<float>>(by_data + std::to_string(i)));
+    }
+    start = std::chrono::steady_clock::now();
+    for (std::size_t i_event{0}; i_event < num_events; i_event++) {
+      for (auto& d : data_members) {
+        d->update(float(i_event));
+        d->save(f);
+      }
+    }
+    std::cout << "save by Data : " << ns_per_value(start, num_values) << " ns/value" << std::endl;
+
+    // the event and run numbers are needed by the reader
+    for (std::size_t i_event{0}; i_event < num_events; i_event++) {
+      f.save(fire::io::constants::EVENT_GROUP + "/"
+             + fire::io::constants::EVENT_HEADER_NAME + "/"
+             + fire::io::constants::NUMBER_NAME, int(i_event));
+    }
+    f.save(fire::io::constants::RUN_HEADER_NAME + "/"
+           + fire::io::constants::NUMBER_NAME, int(0));
+  }
+
+  fire::io::h5::Reader f{file_name};
+
+  float val;
+  auto start = std::chrono::steady_clock::now();
+  for (std::size_t i_event{0}; i_event < num_events; i_event++) {
+    for (const auto& path : path_members) f.load(path, val);
+  }
+  std::cout << "load by path : " << ns_per_value(start, num_values) << " ns/value" << std::endl;
+
+  std::vector<std::unique_ptr<fire::io::Data<float>>> data_members;
+  for (std::size_t i{0}; i < num_members; i++) {
+    data_members.emplace_back(
+        std::make_unique<fire::io::Data<float>>(by_data + std::to_string(i), &f));
+  }
+  start = std::chrono::steady_clock::now();
+  for (std::size_t i_event{0}; i_event < num_events; i_event++) {
+    for (auto& d : data_members) d->load(f);
+  }
+  std::cout << "load by Data : " << ns_per_value(start, num_values) << " ns/value" << std::endl;
+
+  return 0;
+}
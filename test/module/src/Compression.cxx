@@ -0,0 +1,111 @@
+/**
+ * @file Compression.cxx
+ * Benchmark of the compression algorithms available to io::Writer
+ *
+ * For each algorithm, we write the same randomly generated
+ * collections of bench::Hit to a file and then read them back,
+ * reporting the throughput of the uncompressed data in both directions
+ * and the ratio of the uncompressed data size to the file size.
+ * Algorithms whose HDF5 filter plugin is not available are skipped.
+ *
+ * Usage: fire-bench-compression [num_events] [level] [algorithm ...]
+ */
+
+#include <chrono>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "fire/io/Data.h"
+
+#include "Hit.h"
+
+namespace {
+
+/// the number of members attached by bench::Hit, all of which are 4 bytes
+static const std::size_t HIT_BYTES{12*4};
+
+/// the rate in MB/s of processing the input bytes since the input start
+double mb_per_s(std::chrono::steady_clock::time_point start, std::size_t bytes) {
+  std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+  return bytes / 1e6 / elapsed.count();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  std::size_t num_events{argc > 1 ? std::stoul(argv[1]) : 10000ul};
+  int level{argc > 2 ? std::stoi(argv[2]) : 6};
+  std::vector<std::string> algorithms;
+  for (int i{3}; i < argc; i++) algorithms.push_back(argv[i]);
+  if (algorithms.empty()) algorithms = {"none", "deflate", "zstd", "lz4", "blosc"};
+
+  // same random hits for all algorithms
+  std::mt19937 rng;
+  std::uniform_int_distribution<std::size_t> rand_size{1, 100};
+  std::uniform_real_distribution<float> rand_float{0.,100.};
+  std::uniform_int_distribution<int> rand_int{-100,100};
+  std::vector<std::vector<bench::Hit>> events(num_events);
+  std::size_t raw_bytes{0};
+  for (auto& hits : events) {
+    hits.resize(rand_size(rng));
+    for (bench::Hit& hit : hits) {
+      hit.setLayerID(rand_int(rng));
+      hit.setModuleID(rand_int(rng));
+      hit.setTrackID(rand_int(rng));
+      hit.setPdgID(rand_int(rng));
+      hit.setPosition(rand_float(rng),rand_float(rng),rand_float(rng));
+      hit.setEnergy(rand_float(rng));
+      hit.setTime(rand_float(rng));
+      hit.setMomentum(rand_float(rng),rand_float(rng),rand_float(rng));
+    }
+    raw_bytes += hits.size()*HIT_BYTES + sizeof(std::size_t);
+  }
+
+  std::cout << "algorithm : write MB/s, read MB/s, compression ratio" << std::endl;
+  for (const auto& algorithm : algorithms) {
+    std::string file_name{"compression_"+algorithm+".h5"};
+    auto start = std::chrono::steady_clock::now();
+    try {
+      fire::config::Parameters ps;
+      ps.add("name", file_name);
+      ps.add("rows_per_chunk", 10000);
+      ps.add("compression_level", level);
+      ps.add("shuffle", true);
+      ps.add("compression", algorithm);
+      fire::io::Writer f{int(num_events), ps};
+      fire::io::Data<std::vector<bench::Hit>> hits_d{"events/bench/hits"};
+      hits_d.structure(f);
+      for (std::size_t i_event{0}; i_event < num_events; i_event++) {
+        hits_d.update(events[i_event]);
+        hits_d.save(f);
+        // the event and run numbers are needed by the reader
+        f.save(fire::io::constants::EVENT_GROUP + "/"
+               + fire::io::constants::EVENT_HEADER_NAME + "/"
+               + fire::io::constants::NUMBER_NAME, int(i_event));
+      }
+      f.save(fire::io::constants::RUN_HEADER_NAME + "/"
+             + fire::io::constants::NUMBER_NAME, int(0));
+    } catch (const fire::Exception& e) {
+      std::cout << algorithm << " : not available" << std::endl;
+      continue;
+    }
+    double write_rate = mb_per_s(start, raw_bytes);
+
+    start = std::chrono::steady_clock::now();
+    {
+      fire::io::h5::Reader f{file_name};
+      fire::io::Data<std::vector<bench::Hit>> hits_d{"events/bench/hits", &f};
+      for (std::size_t i_event{0}; i_event < num_events; i_event++) hits_d.load(f);
+    }
+    double read_rate = mb_per_s(start, raw_bytes);
+
+    double ratio = double(raw_bytes) / std::filesystem::file_size(file_name);
+    std::cout << algorithm << " : " << write_rate << ", " << read_rate
+              << ", " << ratio << std::endl;
+  }
+
+  return 0;
+}
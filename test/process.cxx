@@ -214,4 +214,53 @@ BOOST_AUTO_TEST_CASE(recon_mode_multi_file, *boost::unit_test::depends_on("proce
   BOOST_TEST(run_numbers == correct);
 }
 
+BOOST_AUTO_TEST_CASE(recon_mode_prefetch, *boost::unit_test::depends_on("process/recon_mode_multi_file")) {
+  std::string output{"recon_mode_prefetch_output.h5"};
+  fire::config::Parameters configuration;
+  configuration.add("pass_name",std::string("test"));
+
+  fire::config::Parameters output_file;
+  output_file.add("name", output);
+  output_file.add("event_limit", 10);
+  output_file.add("rows_per_chunk", 1000);
+  output_file.add("compression_level", 6);
+  output_file.add("shuffle",false);
+  configuration.add("output_file",output_file);
+
+  // read the next chunks of both files in the background
+  std::vector<std::string> input_files = { "production_mode_output.h5", "recon_mode_multi_input.h5" };
+  configuration.add("input_files",input_files );
+  configuration.add("prefetch",true);
+
+  fire::config::Parameters storage;
+  storage.add("default_keep",true);
+  configuration.add("storage",storage);
+
+  configuration.add("event_limit", -1);
+  configuration.add("log_frequency", -1);
+
+  configuration.add("run", 1); // not used for recon mode
+  configuration.add("max_tries", 1); // not used in recon mode
+
+  configuration.add("testing",true); // ok for no sequence
+  configuration.add<fire::config::Parameters>("conditions",{});
+
+  try {
+    fire::Process p(configuration);
+    p.run();
+  } catch (const std::exception& e) {
+    std::cerr << e.what() << std::endl;
+    BOOST_TEST(false);
+  }
+
+  // prefetching does not change what is read
+  H5Easy::File f(output);
+  auto event_numbers = H5Easy::load<std::vector<int>>(f, fire::EventHeader::NAME+"/number");
+  std::vector<int> correct = {1,2,3,4,5,6,7,8,9,10,1,2,3,4,5,6,7,8};
+  BOOST_TEST(event_numbers == correct);
+  auto run_numbers = H5Easy::load<std::vector<int>>(f, fire::RunHeader::NAME+"/number");
+  correct = {2,1};
+  BOOST_TEST(run_numbers == correct);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
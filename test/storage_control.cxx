@@ -112,6 +112,52 @@ BOOST_AUTO_TEST_CASE(voting) {
   BOOST_TEST(sc.keepEvent() == true);
 }
 
+BOOST_AUTO_TEST_CASE(tokens) {
+  fire::config::Parameters storage;
+  storage.add("default_keep", true);
+
+  std::vector<fire::config::Parameters> listening_rules;
+  fire::config::Parameters listening_rule;
+  listening_rule.add<std::string>("processor", ".*Listen.*");
+  listening_rule.add<std::string>("purpose", "");
+  listening_rules.push_back(listening_rule);
+  storage.add("listening_rules",listening_rules);
+
+  fire::StorageControl sc{storage}, other{storage};
+  other.shareWith(sc);
+
+  // the same processor and purpose have the same token on both
+  auto listened{sc.token("", "ListenToMe")};
+  auto ignored{other.token("", "TestProc")};
+  BOOST_TEST(listened.listened);
+  BOOST_TEST(not ignored.listened);
+  BOOST_TEST(other.token("", "ListenToMe").index == listened.index);
+  BOOST_TEST(sc.token("", "TestProc").index == ignored.index);
+
+  // hints with tokens count like hints with strings
+  sc.addHint(fire::StorageControl::Hint::MustDrop, ignored);
+  BOOST_TEST(sc.keepEvent() == true);
+  sc.addHint(fire::StorageControl::Hint::MustDrop, listened);
+  BOOST_TEST(sc.keepEvent() == false);
+  sc.addHint(fire::StorageControl::Hint::ShouldKeep, "", "ListenToMe");
+  sc.addHint(fire::StorageControl::Hint::ShouldKeep, "", "ListenToMe");
+  BOOST_TEST(sc.keepEvent() == true);
+
+  // the votes are counted for each storage control across events
+  sc.resetEventState();
+  other.addHint(fire::StorageControl::Hint::ShouldKeep, "Other", "TestProc");
+  auto votes{sc.votes()};
+  BOOST_REQUIRE(votes.size() == 3);
+  BOOST_TEST(votes.at(listened.index).processor == "ListenToMe");
+  BOOST_TEST(votes.at(listened.index).keep == 2);
+  BOOST_TEST(votes.at(listened.index).drop == 1);
+  BOOST_TEST(votes.at(ignored.index).keep == 0);
+  BOOST_TEST(votes.at(ignored.index).drop == 1);
+  BOOST_TEST(votes.at(2).purpose == "Other");
+  BOOST_TEST(votes.at(2).keep == 0);
+  BOOST_TEST(other.votes().at(2).keep == 1);
+}
+
 BOOST_AUTO_TEST_SUITE(errors)
 
 BOOST_AUTO_TEST_CASE(bad_regex) {